@@ -0,0 +1,3 @@
+// Diffusaire sources, compiled into the combined plugin
+#include "../../Diffusaire/src/DiffusaireModule.cpp"
+#include "../../Diffusaire/src/plugin.cpp"
@@ -0,0 +1,3 @@
+// DubBoite sources, compiled into the combined plugin
+#include "../../DubBoite/src/DubBoiteModule.cpp"
+#include "../../DubBoite/src/plugin.cpp"
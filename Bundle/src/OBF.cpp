@@ -0,0 +1,4 @@
+// OBF sources, compiled into the combined plugin
+#include "../../OBF/src/OBFModule.cpp"
+#include "../../OBF/src/OscillanceModule.cpp"
+#include "../../OBF/src/plugin.cpp"
@@ -0,0 +1,3 @@
+// OscillateurTritonique sources, compiled into the combined plugin
+#include "../../OscillateurTritonique/src/OscillateurTritoniqueModule.cpp"
+#include "../../OscillateurTritonique/src/plugin.cpp"
@@ -0,0 +1,3 @@
+// SirenConcrete sources, compiled into the combined plugin
+#include "../../SirenConcrete/src/SirenConcreteModule.cpp"
+#include "../../SirenConcrete/src/plugin.cpp"
@@ -0,0 +1,3 @@
+// Sonogenese sources, compiled into the combined plugin
+#include "../../Sonogenese/src/SonogeneseModule.cpp"
+#include "../../Sonogenese/src/plugin.cpp"
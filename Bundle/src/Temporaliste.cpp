@@ -0,0 +1,3 @@
+// Temporaliste sources, compiled into the combined plugin
+#include "../../Temporaliste/src/TemporalisteModule.cpp"
+#include "../../Temporaliste/src/plugin.cpp"
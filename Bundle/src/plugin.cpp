@@ -0,0 +1,15 @@
+#include "plugin.hpp"
+
+Plugin* pluginInstance;
+
+void init(Plugin* p) {
+    pluginInstance = p;
+    p->addModel(modelOBFModule);
+    p->addModel(modelOscillance);
+    p->addModel(modelSonogenese);
+    p->addModel(modelDiffusaire);
+    p->addModel(modelSirenConcrete);
+    p->addModel(modelDubBoite);
+    p->addModel(modelOscillateurTritonique);
+    p->addModel(modelTemporaliste);
+}
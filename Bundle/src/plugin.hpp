@@ -0,0 +1,15 @@
+#pragma once
+#include <rack.hpp>
+
+using namespace rack;
+
+extern Plugin* pluginInstance;
+
+extern Model* modelOBFModule;
+extern Model* modelOscillance;
+extern Model* modelSonogenese;
+extern Model* modelDiffusaire;
+extern Model* modelSirenConcrete;
+extern Model* modelDubBoite;
+extern Model* modelOscillateurTritonique;
+extern Model* modelTemporaliste;
@@ -20,6 +20,48 @@ DiffusaireModule::DiffusaireModule() {
 	configInput(ECART_INPUT, "Écart CV");
 	configInput(CINETIQUES_INPUT, "Cinétiques CV");
 	configOutput(AUDIO_OUTPUT, "Audio");
+	
+	contoursParam.config(CONTOURS_PARAM, CONTOURS_INPUT, CONTOURS_ATTEN_PARAM);
+	resonanceParam.config(RESONANCE_PARAM, RESONANCE_INPUT, RESONANCE_ATTEN_PARAM);
+	ecartParam.config(ECART_PARAM, ECART_INPUT, ECART_ATTEN_PARAM);
+	cinetiquesParam.config(CINETIQUES_PARAM, CINETIQUES_INPUT, CINETIQUES_ATTEN_PARAM);
+	controlDivider.setDivision(mpdsp::CONTROL_BLOCK_SIZE);
+	
+	// The motion delay only takes its memory once Cinétiques is turned up
+	delayLine.reserve(DELAY_SIZE);
+	tables = mpdsp::sharedTables();
+	idle.setTail((int)(TAIL_TIME * 48000.f));
+	applyQuality(mpdsp::resolveQuality(quality));
+}
+
+void DiffusaireModule::onSampleRateChange(const SampleRateChangeEvent& e) {
+	// Pole coefficients and the tail length depend on the sample rate
+	contoursParam.reset();
+	idle.setTail((int)(TAIL_TIME * e.sampleRate));
+}
+
+json_t* DiffusaireModule::dataToJson() {
+	json_t* rootJ = json_object();
+	json_object_set_new(rootJ, "quality", json_integer(quality));
+	return rootJ;
+}
+
+void DiffusaireModule::dataFromJson(json_t* rootJ) {
+	json_t* qualityJ = json_object_get(rootJ, "quality");
+	if (qualityJ) {
+		quality = clamp((int)json_integer_value(qualityJ), mpdsp::QUALITY_DEFAULT, mpdsp::NUM_QUALITIES - 1);
+	}
+}
+
+void DiffusaireModule::applyQuality(int tier) {
+	// Eco halves the dispersion cascade and reads knobs half as often; High
+	// reads them twice as often and interpolates the motion delay cubically
+	static const int ALLPASS_DEPTHS[mpdsp::NUM_QUALITIES] = {NUM_ALLPASS / 2, NUM_ALLPASS, NUM_ALLPASS};
+	static const int CONTROL_BLOCK_SIZES[mpdsp::NUM_QUALITIES] = {64, 32, 16};
+	appliedQuality = tier;
+	activeAllpasses = ALLPASS_DEPTHS[tier];
+	cubicDelay = (tier == mpdsp::QUALITY_HIGH);
+	controlDivider.setDivision(CONTROL_BLOCK_SIZES[tier]);
 }
 
 void DiffusaireModule::process(const ProcessArgs& args) {
@@ -30,34 +72,35 @@ void DiffusaireModule::process(const ProcessArgs& args) {
 	
 	float input = inputs[AUDIO_INPUT].getVoltage();
 	
-	// Get parameters with CV and attenuverters
-	float contours = params[CONTOURS_PARAM].getValue();
-	if (inputs[CONTOURS_INPUT].isConnected()) {
-		float cv = inputs[CONTOURS_INPUT].getVoltage() / 10.0f;
-		float atten = params[CONTOURS_ATTEN_PARAM].getValue();
-		contours = clamp(contours + cv * atten, 0.0f, 1.0f);
+	// Asleep while the input is silent and the last tail has died away
+	if (idle.isIdle(input)) {
+		outputs[AUDIO_OUTPUT].setVoltage(0.f);
+		return;
 	}
 	
-	float resonance = params[RESONANCE_PARAM].getValue();
-	if (inputs[RESONANCE_INPUT].isConnected()) {
-		float cv = inputs[RESONANCE_INPUT].getVoltage() / 10.0f;
-		float atten = params[RESONANCE_ATTEN_PARAM].getValue();
-		resonance = clamp(resonance + cv * atten, 0.0f, 1.0f);
+	// Get parameters with CV and attenuverters
+	bool blockStart = controlDivider.process();
+	if (blockStart && mpdsp::resolveQuality(quality) != appliedQuality) {
+		applyQuality(mpdsp::resolveQuality(quality));
 	}
-	
-	float ecart = params[ECART_PARAM].getValue();
-	if (inputs[ECART_INPUT].isConnected()) {
-		float cv = inputs[ECART_INPUT].getVoltage() / 10.0f;
-		float atten = params[ECART_ATTEN_PARAM].getValue();
-		ecart = clamp(ecart + cv * atten, 0.0f, 1.0f);
+	int blockSize = (int)controlDivider.getDivision();
+	// Contours only feeds coefficients, which go by its block target
+	contoursParam.process(this, blockStart, blockSize);
+	float resonance = resonanceParam.process(this, blockStart, blockSize);
+	float ecart = ecartParam.process(this, blockStart, blockSize);
+	float cinetiques = cinetiquesParam.process(this, blockStart, blockSize);
+	
+	if (contoursParam.targetChanged()) {
+		updateContours(contoursParam.target(), args.sampleRate, blockSize, contoursParam.restartedBlock());
 	}
-	
-	float cinetiques = params[CINETIQUES_PARAM].getValue();
-	if (inputs[CINETIQUES_INPUT].isConnected()) {
-		float cv = inputs[CINETIQUES_INPUT].getVoltage() / 10.0f;
-		float atten = params[CINETIQUES_ATTEN_PARAM].getValue();
-		cinetiques = clamp(cinetiques + cv * atten, 0.0f, 1.0f);
+	if (ecartParam.targetChanged()) {
+		updateEcart(ecartParam.target(), blockSize, ecartParam.restartedBlock());
 	}
+	cutoffFreq.process();
+	bypassBlend.process();
+	poleCoeffs.process();
+	poleDamping.process();
+	allpassCoeffs.process();
 	
 	// ================================================================
 	// SIGNAL PROCESSING CHAIN
@@ -69,15 +112,15 @@ void DiffusaireModule::process(const ProcessArgs& args) {
 	output = processCinetiques(output, cinetiques, args.sampleRate);
 	
 	// Stage 2: Contours (morphing multi-band cutoff)
-	float cutoffFreq = 20.0f * std::pow(1000.0f, contours);
-	output = processContours(output, contours, args.sampleRate);
+	output = processContours(output);
 	
 	// Stage 3: Résonance Variable (character-changing resonance)
-	output = processResonanceVariable(output, resonance, cutoffFreq, args.sampleRate);
+	output = processResonanceVariable(output, resonance, cutoffFreq.value[0], args.sampleRate);
 	
 	// Stage 4: Écart (phase dispersion)
 	output = processEcart(output, ecart);
 	
+	idle.observe(std::max(std::abs(input), std::abs(output)));
 	outputs[AUDIO_OUTPUT].setVoltage(clamp(output, -10.0f, 10.0f));
 }
 
@@ -85,54 +128,76 @@ void DiffusaireModule::process(const ProcessArgs& args) {
 // DSP HELPER FUNCTIONS
 // ================================================================
 
-float DiffusaireModule::processContours(float input, float contours, float sampleRate) {
-	// Morphing multi-band cutoff with cascaded filters
+void DiffusaireModule::updateContours(float contours, float sampleRate, int blockSize, bool jump) {
 	// Poles move in relation to create shifting boundaries
-	
-	float baseFreq = 20.0f * std::pow(1000.0f, contours);
+	float cutoff = 20.0f * mpdsp::exp2(contours * LOG2_1000);
+	cutoffFreq.target[0] = cutoff;
 	
 	// Smooth crossfade to bypass at very high frequencies
 	float maxSafeFreq = sampleRate * 0.33f;
-	float bypassBlend = 0.0f;
-	if (baseFreq > maxSafeFreq * 0.85f) {
-		bypassBlend = (baseFreq - maxSafeFreq * 0.85f) / (maxSafeFreq * 0.15f);
-		bypassBlend = clamp(bypassBlend, 0.0f, 1.0f);
+	float blend = 0.0f;
+	if (cutoff > maxSafeFreq * 0.85f) {
+		blend = (cutoff - maxSafeFreq * 0.85f) / (maxSafeFreq * 0.15f);
+		blend = clamp(blend, 0.0f, 1.0f);
 	}
+	bypassBlend.target[0] = blend;
 	
-	float output = input;
-	
-	// Process through cascaded poles with spread positions
 	for (int i = 0; i < NUM_POLES; i++) {
 		// Each pole has a different offset frequency
 		float poleSpread = 1.0f + (float)i * 0.15f * contours;
-		float poleFreq = baseFreq * poleSpread;
+		float poleFreq = cutoff * poleSpread;
 		
 		// Clamp to stable range with smoother limiting
 		poleFreq = clamp(poleFreq, 20.0f, sampleRate * 0.38f);
 		float freq = clamp(poleFreq / sampleRate, 0.0001f, 0.38f);
 		
 		// Smoother coefficient calculation
-		float f = 2.0f * std::sin(M_PI * freq);
-		f = clamp(f, 0.0001f, 1.5f);
+		float f = 2.0f * tables->sin2pi(0.5f * freq);
+		poleCoeffs.target[i] = clamp(f, 0.0001f, 1.5f);
 		
 		// Adaptive damping - more damping at high frequencies
-		float q = 0.7f + (1.0f - freq) * 0.2f;
+		poleDamping.target[i] = 0.7f + (1.0f - freq) * 0.2f;
+	}
+	
+	cutoffFreq.start(blockSize, jump);
+	bypassBlend.start(blockSize, jump);
+	poleCoeffs.start(blockSize, jump);
+	poleDamping.start(blockSize, jump);
+}
+
+void DiffusaireModule::updateEcart(float ecart, int blockSize, bool jump) {
+	// Stronger coefficients further down the cascade for an audible effect
+	for (int i = 0; i < NUM_ALLPASS; i++) {
+		float coeff = 0.5f + (float)i * 0.15f * ecart;
+		allpassCoeffs.target[i] = clamp(coeff, 0.0f, 0.95f);
+	}
+	allpassCoeffs.start(blockSize, jump);
+}
+
+float DiffusaireModule::processContours(float input) {
+	// Morphing multi-band cutoff with cascaded filters
+	float output = input;
+	
+	// Process through cascaded poles with spread positions
+	for (int i = 0; i < NUM_POLES; i++) {
+		float f = poleCoeffs.value[i];
+		float q = poleDamping.value[i];
 		
 		// State-variable filter
 		lowpass[i] += f * bandpass[i];
 		highpass[i] = output - lowpass[i] - q * bandpass[i];
 		bandpass[i] += f * highpass[i];
 		
-		// Clamp states to prevent runaway
-		lowpass[i] = clamp(lowpass[i], -10.0f, 10.0f);
-		bandpass[i] = clamp(bandpass[i], -10.0f, 10.0f);
+		// Clamp states to prevent runaway, flush them before they go subnormal
+		lowpass[i] = mpdsp::flushDenormal(clamp(lowpass[i], -10.0f, 10.0f));
+		bandpass[i] = mpdsp::flushDenormal(clamp(bandpass[i], -10.0f, 10.0f));
 		highpass[i] = clamp(highpass[i], -10.0f, 10.0f);
 		
 		output = lowpass[i];
 	}
 	
 	// Smooth crossfade to dry signal at extreme high frequencies
-	return output * (1.0f - bypassBlend) + input * bypassBlend;
+	return output * (1.0f - bypassBlend.value[0]) + input * bypassBlend.value[0];
 }
 
 float DiffusaireModule::processResonanceVariable(float input, float resonance, float freq, float sampleRate) {
@@ -154,7 +219,7 @@ float DiffusaireModule::processResonanceVariable(float input, float resonance, f
 		float resAmount = (resonance - 0.33f) / 0.33f;
 		// Ringing oscillation at cutoff frequency
 		float ringFreq = clamp(freq / sampleRate, 0.001f, 0.45f);
-		float ring = std::sin(2.0f * M_PI * lfoPhase * ringFreq * 100.0f);
+		float ring = tables->sin2pi(lfoPhase.phase * ringFreq * 100.0f);
 		output = input + ring * resAmount * 0.6f;
 		
 		// Feedback with metallic character
@@ -166,14 +231,15 @@ float DiffusaireModule::processResonanceVariable(float input, float resonance, f
 		float resAmount = (resonance - 0.66f) / 0.34f;
 		
 		// Create granular resonance with waveshaping
-		float shaped = std::tanh(input * (1.0f + resAmount * 3.0f));
-		float fractal = shaped + std::sin(shaped * 20.0f * M_PI) * resAmount * 0.4f;
+		float shaped = mpdsp::tanh(input * (1.0f + resAmount * 3.0f));
+		float fractal = shaped + tables->sin2pi(shaped * 10.0f) * resAmount * 0.4f;
 		
 		// Add aggressive feedback
 		resonanceMemory = fractal * 0.98f + resonanceMemory * resAmount * 0.7f;
 		output = input * (1.0f - resAmount) + (fractal + resonanceMemory) * resAmount;
 	}
 	
+	resonanceMemory = mpdsp::flushDenormal(resonanceMemory);
 	return clamp(output, -10.0f, 10.0f);
 }
 
@@ -184,11 +250,9 @@ float DiffusaireModule::processEcart(float input, float ecart) {
 	
 	float output = input;
 	
-	// Cascade of all-pass filters with stronger coefficients for audible effect
-	for (int i = 0; i < NUM_ALLPASS; i++) {
-		float coeff = 0.5f + (float)i * 0.15f * ecart;
-		coeff = clamp(coeff, 0.0f, 0.95f);
-		output = allpassFilter(output, coeff, i);
+	// Cascade of all-pass filters
+	for (int i = 0; i < activeAllpasses; i++) {
+		output = allpasses[i].process(output, allpassCoeffs.value[i]);
 	}
 	
 	// More aggressive blend for pronounced spatial effect
@@ -198,21 +262,18 @@ float DiffusaireModule::processEcart(float input, float ecart) {
 float DiffusaireModule::processCinetiques(float input, float cinetiques, float sampleRate) {
 	// Micro-motion: wow, flutter, drift via modulated delay
 	
-	if (cinetiques < 0.01f) return input;
+	if (cinetiques < 0.01f || !delayLine.acquire()) return input;
 	
 	// Write to delay line
-	delayLine[delayWritePos] = input;
-	delayWritePos = (delayWritePos + 1) % DELAY_SIZE;
+	delayLine.push(input);
 	
 	// Generate organic LFO modulation (multiple rates)
-	lfoPhase += 0.3f / sampleRate;  // Slow drift
-	lfoPhase2 += 2.7f / sampleRate; // Flutter
-	if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
-	if (lfoPhase2 >= 1.0f) lfoPhase2 -= 1.0f;
+	float drift = lfoPhase.process(0.3f / sampleRate);   // Slow drift
+	float flicker = lfoPhase2.process(2.7f / sampleRate); // Flutter
 	
 	// Combine LFO rates for tape-like character
-	float wow = std::sin(2.0f * M_PI * lfoPhase) * cinetiques * 30.0f;
-	float flutter = std::sin(2.0f * M_PI * lfoPhase2) * cinetiques * 8.0f;
+	float wow = mpdsp::sin2pi(drift) * cinetiques * 30.0f;
+	float flutter = mpdsp::sin2pi(flicker) * cinetiques * 8.0f;
 	float modulation = wow + flutter;
 	
 	// Variable delay time
@@ -220,22 +281,8 @@ float DiffusaireModule::processCinetiques(float input, float cinetiques, float s
 	delayTime = clamp(delayTime, 1.0f, (float)(DELAY_SIZE - 2));
 	
 	// Read from delay with interpolation
-	int readPos = (delayWritePos - (int)delayTime + DELAY_SIZE) % DELAY_SIZE;
-	float frac = delayTime - (int)delayTime;
-	int nextReadPos = (readPos - 1 + DELAY_SIZE) % DELAY_SIZE;
-	
-	float delayed = delayLine[readPos] * (1.0f - frac) + delayLine[nextReadPos] * frac;
+	float delayed = cubicDelay ? delayLine.readCubic(delayTime) : delayLine.readLinear(delayTime);
 	
 	// Blend with dry signal
 	return input * (1.0f - cinetiques * 0.4f) + delayed * (cinetiques * 0.4f);
 }
-
-float DiffusaireModule::allpassFilter(float input, float coeff, int stage) {
-	// First-order all-pass filter
-	// H(z) = (coeff + z^-1) / (1 + coeff * z^-1)
-	
-	float output = -coeff * input + allpassState[stage][0];
-	allpassState[stage][0] = input + coeff * output;
-	
-	return output;
-}
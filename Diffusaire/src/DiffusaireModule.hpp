@@ -1,5 +1,14 @@
 #pragma once
 #include "plugin.hpp"
+#include "mpdsp/AllPass.hpp"
+#include "mpdsp/ControlParam.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/Denormal.hpp"
+#include "mpdsp/IdleDetector.hpp"
+#include "mpdsp/Phasor.hpp"
+#include "mpdsp/Quality.hpp"
+#include "mpdsp/FastMath.hpp"
+#include "mpdsp/Tables.hpp"
 
 struct DiffusaireModule : Module {
 	enum ParamId {
@@ -29,35 +38,70 @@ struct DiffusaireModule : Module {
 		NUM_LIGHTS
 	};
 
+	// Contours sweeps 20 Hz to 20 kHz: 20 * 1000^contours
+	static constexpr float LOG2_1000 = 9.9657842847f;
+	
 	// Multi-pole filter state (cascaded filters)
 	static const int NUM_POLES = 4;
 	float lowpass[NUM_POLES] = {};
 	float bandpass[NUM_POLES] = {};
 	float highpass[NUM_POLES] = {};
 	
+	// Filter coefficients derived from contours, worked out once per control
+	// block when it moves and ramped across the block
+	mpdsp::CoeffRamp<float, 1> cutoffFreq;
+	mpdsp::CoeffRamp<float, 1> bypassBlend;
+	mpdsp::CoeffRamp<float, NUM_POLES> poleCoeffs;
+	mpdsp::CoeffRamp<float, NUM_POLES> poleDamping;
+	
 	// All-pass networks for phase dispersion
 	static const int NUM_ALLPASS = 6;
-	float allpassState[NUM_ALLPASS][2] = {};  // [stage][z1, z2]
+	mpdsp::AllPass1<float> allpasses[NUM_ALLPASS];
+	mpdsp::CoeffRamp<float, NUM_ALLPASS> allpassCoeffs;
+	int activeAllpasses = NUM_ALLPASS;
 	
 	// Delay line for cinétiques (micro-motion)
 	static const int DELAY_SIZE = 8192;
-	float delayLine[DELAY_SIZE] = {};
-	int delayWritePos = 0;
+	mpdsp::DelayLine<float> delayLine;
+	bool cubicDelay = false;
 	
 	// LFO for organic fluctuations
-	float lfoPhase = 0.0f;
-	float lfoPhase2 = 0.0f;
+	mpdsp::Phasor<float> lfoPhase;
+	mpdsp::Phasor<float> lfoPhase2;
 	
 	// Resonance character state
 	float resonanceMemory = 0.0f;
+	
+	const mpdsp::Tables* tables;
+	
+	// Knob and CV inputs, read at control rate
+	mpdsp::ControlParam contoursParam;
+	mpdsp::ControlParam resonanceParam;
+	mpdsp::ControlParam ecartParam;
+	mpdsp::ControlParam cinetiquesParam;
+	dsp::ClockDivider controlDivider;
+	
+	// Sleeps through silent input once the filters have rung out
+	static constexpr float TAIL_TIME = 0.5f;
+	mpdsp::IdleDetector idle;
+	
+	// Quality tier, saved with the patch; appliedQuality is the tier the
+	// settings above were last sized for
+	int quality = mpdsp::QUALITY_DEFAULT;
+	int appliedQuality = -1;
 
 	DiffusaireModule();
 	void process(const ProcessArgs& args) override;
+	void onSampleRateChange(const SampleRateChangeEvent& e) override;
+	json_t* dataToJson() override;
+	void dataFromJson(json_t* rootJ) override;
+	void applyQuality(int tier);
 
 	// DSP functions
-	float processContours(float input, float contours, float sampleRate);
+	void updateContours(float contours, float sampleRate, int blockSize, bool jump);
+	void updateEcart(float ecart, int blockSize, bool jump);
+	float processContours(float input);
 	float processResonanceVariable(float input, float resonance, float freq, float sampleRate);
 	float processEcart(float input, float ecart);
 	float processCinetiques(float input, float cinetiques, float sampleRate);
-	float allpassFilter(float input, float coeff, int stage);
 };
@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "DiffusaireModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
 	pluginInstance = p;
 	p->addModel(modelDiffusaire);
 }
+#endif
 
 struct DiffusaireWidget : ModuleWidget {
 	DiffusaireWidget(DiffusaireModule* module) {
@@ -110,6 +113,19 @@ struct DiffusaireWidget : ModuleWidget {
 		outLabel->color = nvgRGB(200, 200, 200);
 		addChild(outLabel);
 	}
+
+	// Picks up default quality changes made from other plugins
+	void step() override {
+		mpdsp::pollDefaultQuality();
+		ModuleWidget::step();
+	}
+
+	void appendContextMenu(Menu* menu) override {
+		DiffusaireModule* module = getModule<DiffusaireModule>();
+
+		menu->addChild(new MenuSeparator);
+		mpdsp::appendQualityMenu(menu, &module->quality);
+	}
 };
 
 Model* modelDiffusaire = createModel<DiffusaireModule, DiffusaireWidget>("Diffusaire");
@@ -1,6 +1,16 @@
 #include "DubBoiteModule.hpp"
 #include <cmath>
 
+namespace {
+
+// Loudest of the four channel lanes
+float peak(simd::float_4 v) {
+    v = simd::fabs(v);
+    return std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+}
+
+} // namespace
+
 DubBoiteModule::DubBoiteModule() {
     config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
     
@@ -28,91 +38,124 @@ DubBoiteModule::DubBoiteModule() {
     configOutput(SEND_OUTPUT, "Effects Send");
     
     masterVu.lambda = 1 / 0.1f; // 100ms integration time
+    tables = mpdsp::sharedTables();
+    
+    // Delay memory is only taken once scrub or diffusion is turned up
+    delayBuffers.reserve(DELAY_SIZE);
+    for (int i = 0; i < NUM_PATHS; i++) {
+        diffusionPaths[i].reserve(DELAY_SIZE);
+    }
+    // Nothing is read further back than the buffers reach
+    idle.setTail(DELAY_SIZE);
+    applyQuality(mpdsp::resolveQuality(quality));
+}
+
+json_t* DubBoiteModule::dataToJson() {
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "quality", json_integer(quality));
+    return rootJ;
+}
+
+void DubBoiteModule::dataFromJson(json_t* rootJ) {
+    json_t* qualityJ = json_object_get(rootJ, "quality");
+    if (qualityJ) {
+        quality = clamp((int)json_integer_value(qualityJ), mpdsp::QUALITY_DEFAULT, mpdsp::NUM_QUALITIES - 1);
+    }
+}
+
+void DubBoiteModule::applyQuality(int tier) {
+    // Eco feeds every other diffusion path; High scrubs with a fractional,
+    // interpolated delay instead of whole samples
+    appliedQuality = tier;
+    pathStride = (tier == mpdsp::QUALITY_ECO) ? 2 : 1;
+    fractionalScrub = (tier == mpdsp::QUALITY_HIGH);
 }
 
 float DubBoiteModule::processSendDiffusion(float input, float diffusion) {
     if (diffusion < 0.01f) return 0.f;
     
     float output = 0.f;
-    for (int i = 0; i < NUM_PATHS; i++) {
+    for (int i = 0; i < NUM_PATHS; i += pathStride) {
         int delayMs = 10 + i * 10; // 10ms to 80ms
         int delaySamples = (int)(delayMs * 48.f); // Assume 48kHz
         
-        // Write input to path
-        diffusionPaths[i][diffusionWritePos[i]] = input;
+        // A path joins in once its memory has arrived
+        if (!diffusionPaths[i].acquire()) continue;
         
-        // Read delayed signal
-        int readPos = (diffusionWritePos[i] - delaySamples + DELAY_SIZE) % DELAY_SIZE;
-        float delayed = diffusionPaths[i][readPos];
+        // Write input to path, then read the delayed signal
+        diffusionPaths[i].push(input);
+        float delayed = diffusionPaths[i].read(delaySamples);
         
         // Apply spectral coloration
         float brightness = (float)i / NUM_PATHS;
         output += delayed * (0.7f + brightness * 0.3f) / NUM_PATHS;
-        
-        diffusionWritePos[i] = (diffusionWritePos[i] + 1) % DELAY_SIZE;
     }
     
-    return output * diffusion;
+    return output * diffusion * pathStride;
 }
 
-float DubBoiteModule::processTapeScrub(float input, int channel, float scrub, float sampleTime) {
-    // LFO with harmonics
+simd::float_4 DubBoiteModule::processTapeScrub(simd::float_4 input, float scrub, float sampleTime) {
+    if (scrub < 0.01f || !delayBuffers.acquire()) return input;
+    
+    // LFO with harmonics, all three partials in one call
     float lfoFreq = 0.3f + scrub * 2.f; // 0.3-2.3Hz
     scrubPhase += lfoFreq * sampleTime;
     if (scrubPhase >= 1.f) scrubPhase -= 1.f;
     
-    float lfo = std::sin(2.f * M_PI * scrubPhase);
-    lfo += std::sin(2.f * M_PI * scrubPhase * 2.7f) * 0.3f;
-    lfo += std::sin(2.f * M_PI * scrubPhase * 5.3f) * 0.2f;
+    simd::float_4 partials = mpdsp::sin2pi(scrubPhase * simd::float_4(1.f, 2.7f, 5.3f, 0.f));
+    float lfo = partials[0] + partials[1] * 0.3f + partials[2] * 0.2f;
     
     // Modulated delay 5-25ms
-    int baseDelay = (int)(15.f * 48.f);
-    int modDelay = (int)(10.f * 48.f * lfo * scrub);
-    int totalDelay = clamp(baseDelay + modDelay, 1, DELAY_SIZE - 1);
-    
-    delayBuffers[channel][delayWritePos[channel]] = input;
-    int readPos = (delayWritePos[channel] - totalDelay + DELAY_SIZE) % DELAY_SIZE;
-    float output = delayBuffers[channel][readPos];
-    
-    delayWritePos[channel] = (delayWritePos[channel] + 1) % DELAY_SIZE;
+    delayBuffers.push(input);
+    simd::float_4 output;
+    if (fractionalScrub) {
+        float totalDelay = clamp(15.f * 48.f + 10.f * 48.f * lfo * scrub, 1.f, (float)(DELAY_SIZE - 2));
+        output = delayBuffers.readLinear(totalDelay);
+    }
+    else {
+        int baseDelay = (int)(15.f * 48.f);
+        int modDelay = (int)(10.f * 48.f * lfo * scrub);
+        int totalDelay = clamp(baseDelay + modDelay, 1, DELAY_SIZE - 1);
+        output = delayBuffers.read(totalDelay);
+    }
     
     return output * scrub + input * (1.f - scrub);
 }
 
-float DubBoiteModule::processLowDrift(float input, int channel, float drift, float sampleTime) {
+simd::float_4 DubBoiteModule::processLowDrift(simd::float_4 input, float drift, float sampleTime) {
     if (drift < 0.01f) return input;
     
     // 200Hz lowpass
     float cutoff = 200.f;
     float rc = 1.f / (2.f * M_PI * cutoff);
     float alpha = sampleTime / (rc + sampleTime);
-    lowpassState[channel] += alpha * (input - lowpassState[channel]);
+    lowpassState = mpdsp::flushDenormal(lowpassState + alpha * (input - lowpassState));
     
     // Drift LFO at 0.2Hz
     lowDriftPhase += 0.2f * sampleTime;
     if (lowDriftPhase >= 1.f) lowDriftPhase -= 1.f;
-    float lfo = std::sin(2.f * M_PI * lowDriftPhase);
+    float lfo = tables->sin2pi(lowDriftPhase);
     
     // Mix drifted lows back
-    float driftedLow = lowpassState[channel] * (1.f + lfo * drift * 0.3f);
+    simd::float_4 driftedLow = lowpassState * (1.f + lfo * drift * 0.3f);
     return input * (1.f - drift * 0.5f) + driftedLow * drift * 0.5f;
 }
 
-float DubBoiteModule::processSaturationBloom(float input, int channel, float bloom) {
+simd::float_4 DubBoiteModule::processSaturationBloom(simd::float_4 input, float bloom) {
     if (bloom < 0.01f) return input;
     
     float drive = 1.f + bloom * 3.f; // 1-4x
-    float driven = input * drive;
+    simd::float_4 driven = input * drive;
     
     // Tanh saturation
-    float saturated = std::tanh(driven);
+    simd::float_4 saturated = mpdsp::tanh(driven);
     
     // Harmonic waveshaping
-    float shaped = saturated + std::sin(saturated * 3.f * M_PI) * bloom * 0.2f;
+    simd::float_4 shaped = saturated + mpdsp::sin2pi(saturated * 1.5f) * bloom * 0.2f;
     
     // Feedback
-    saturationMemory[channel] = shaped * 0.1f;
-    shaped += saturationMemory[channel] * bloom;
+    saturationMemory = shaped * 0.1f;
+    shaped += saturationMemory * bloom;
     
     return shaped;
 }
@@ -124,37 +167,48 @@ void DubBoiteModule::process(const ProcessArgs& args) {
     float saturation = params[SATURATION_KNOB].getValue();
     float master = params[MASTER_FADER].getValue();
     
-    float mixSum = 0.f;
-    float sendSum = 0.f;
+    if (mpdsp::resolveQuality(quality) != appliedQuality) {
+        applyQuality(mpdsp::resolveQuality(quality));
+    }
     
+    simd::float_4 sig = 0.f;
+    simd::float_4 connected = 0.f;
     for (int i = 0; i < 4; i++) {
-        if (!inputs[CH1_INPUT + i].isConnected()) {
+        if (!inputs[CH1_INPUT + i].isConnected()) continue;
+        sig[i] = inputs[CH1_INPUT + i].getVoltage() * params[CH1_FADER + i].getValue();
+        connected[i] = 1.f;
+    }
+    
+    float mixSum = 0.f;
+    float sendOut = 0.f;
+    float inputPeak = peak(sig);
+    if (idle.isIdle(inputPeak)) {
+        // Asleep: every channel is silent and the delays have emptied
+        for (int i = 0; i < 4; i++) {
             lights[CH1_LIGHT + i].setBrightness(0.f);
-            continue;
         }
-        
-        float input = inputs[CH1_INPUT + i].getVoltage();
-        float fader = params[CH1_FADER + i].getValue();
-        
+    }
+    else {
         // Process chain
-        float sig = input * fader;
-        sig = processTapeScrub(sig, i, scrub, args.sampleTime);
-        sig = processLowDrift(sig, i, lowdrift, args.sampleTime);
-        sig = processSaturationBloom(sig, i, saturation);
+        sig = processTapeScrub(sig, scrub, args.sampleTime);
+        sig = processLowDrift(sig, lowdrift, args.sampleTime);
+        sig = processSaturationBloom(sig, saturation);
+        // Unplugged channels stay out of the mix, as if they had been skipped
+        sig *= connected;
+        
+        mixSum = sig[0] + sig[1] + sig[2] + sig[3];
         
-        // Send to diffusion
-        sendSum += sig * diffusion;
+        // Channel lights
+        for (int i = 0; i < 4; i++) {
+            lights[CH1_LIGHT + i].setBrightness(std::abs(sig[i]) * 0.2f);
+        }
         
-        // Mix
-        mixSum += sig;
+        // Process send diffusion
+        sendOut = processSendDiffusion(mixSum * diffusion, diffusion);
         
-        // Channel light
-        lights[CH1_LIGHT + i].setBrightness(std::abs(sig) * 0.2f);
+        idle.observe(std::max(std::max(inputPeak, peak(sig)), std::abs(sendOut)));
     }
     
-    // Process send diffusion
-    float sendOut = processSendDiffusion(sendSum, diffusion);
-    
     // Apply master
     float finalMix = mixSum * master;
     
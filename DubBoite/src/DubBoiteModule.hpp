@@ -1,9 +1,16 @@
 #pragma once
 #include <rack.hpp>
+#include "mpdsp/Aligned.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/Denormal.hpp"
+#include "mpdsp/FastMath.hpp"
+#include "mpdsp/IdleDetector.hpp"
+#include "mpdsp/Quality.hpp"
+#include "mpdsp/Tables.hpp"
 
 using namespace rack;
 
-struct DubBoiteModule : Module {
+struct DubBoiteModule : Module, mpdsp::CacheAligned {
     enum ParamIds {
         // Channel faders
         CH1_FADER,
@@ -43,23 +50,41 @@ struct DubBoiteModule : Module {
     static constexpr int DELAY_SIZE = 16384;
     static constexpr int NUM_PATHS = 8;
     
-    float delayBuffers[4][DELAY_SIZE] = {};
-    int delayWritePos[4] = {};
-    float diffusionPaths[NUM_PATHS][DELAY_SIZE] = {};
-    int diffusionWritePos[NUM_PATHS] = {};
-    float lowpassState[4] = {};
-    float saturationMemory[4] = {};
+    // Per-sample state, together and starting on a cache line so one
+    // sample touches as few lines as possible. The delay memory itself is
+    // allocated separately by the delay lines, so these stay a few lines
+    // apart no matter how long the buffers are
+    alignas(mpdsp::CACHE_LINE) simd::float_4 lowpassState = 0.f;
+    simd::float_4 saturationMemory = 0.f;
     float scrubPhase = 0.f;
     float lowDriftPhase = 0.f;
+    const mpdsp::Tables* tables;
+    // Sleeps through silence once every delay line has emptied
+    mpdsp::IdleDetector idle;
+    
+    // Quality tier, saved with the patch; appliedQuality is the tier the
+    // diffusion stride and scrub interpolation were last set for
+    int quality = mpdsp::QUALITY_DEFAULT;
+    int appliedQuality = -1;
+    int pathStride = 1;
+    bool fractionalScrub = false;
+    
+    // The four channel strips run side by side, one SIMD lane each. Both
+    // delays take their memory from the buffer pool on first use
+    mpdsp::DelayLine<simd::float_4> delayBuffers;
+    mpdsp::DelayLine<float> diffusionPaths[NUM_PATHS];
     
     // VU meter
     dsp::VuMeter2 masterVu;
 
     DubBoiteModule();
     void process(const ProcessArgs& args) override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void applyQuality(int tier);
     
     float processSendDiffusion(float input, float diffusion);
-    float processTapeScrub(float input, int channel, float scrub, float sampleTime);
-    float processLowDrift(float input, int channel, float drift, float sampleTime);
-    float processSaturationBloom(float input, int channel, float bloom);
+    simd::float_4 processTapeScrub(simd::float_4 input, float scrub, float sampleTime);
+    simd::float_4 processLowDrift(simd::float_4 input, float drift, float sampleTime);
+    simd::float_4 processSaturationBloom(simd::float_4 input, float bloom);
 };
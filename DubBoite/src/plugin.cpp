@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "DubBoiteModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
     pluginInstance = p;
     p->addModel(modelDubBoite);
 }
+#endif
 
 struct DubBoiteWidget : ModuleWidget {
     DubBoiteWidget(DubBoiteModule* module) {
@@ -165,6 +168,19 @@ struct DubBoiteWidget : ModuleWidget {
         sendLabel->color = nvgRGB(200, 200, 200);
         addChild(sendLabel);
     }
+
+    // Picks up default quality changes made from other plugins
+    void step() override {
+        mpdsp::pollDefaultQuality();
+        ModuleWidget::step();
+    }
+
+    void appendContextMenu(Menu* menu) override {
+        DubBoiteModule* module = getModule<DubBoiteModule>();
+
+        menu->addChild(new MenuSeparator);
+        mpdsp::appendQualityMenu(menu, &module->quality);
+    }
 };
 
 Model* modelDubBoite = createModel<DubBoiteModule, DubBoiteWidget>("DubBoite");
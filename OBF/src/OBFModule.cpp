@@ -4,16 +4,230 @@
 
 using namespace rack;
 
+namespace {
+
+// Classic chaotic parameter sets
+void lorenz(const float* s, float* d) {
+    d[0] = 10.0f * (s[1] - s[0]);
+    d[1] = s[0] * (28.0f - s[2]) - s[1];
+    d[2] = s[0] * s[1] - (8.0f / 3.0f) * s[2];
+}
+
+void rossler(const float* s, float* d) {
+    d[0] = -s[1] - s[2];
+    d[1] = s[0] + 0.2f * s[1];
+    d[2] = 0.2f + s[2] * (s[0] - 5.7f);
+}
+
+void rk4(void (*f)(const float*, float*), float* s, float h) {
+    float k1[3], k2[3], k3[3], k4[3], t[3];
+    f(s, k1);
+    for (int i = 0; i < 3; i++) t[i] = s[i] + 0.5f * h * k1[i];
+    f(t, k2);
+    for (int i = 0; i < 3; i++) t[i] = s[i] + 0.5f * h * k2[i];
+    f(t, k3);
+    for (int i = 0; i < 3; i++) t[i] = s[i] + h * k3[i];
+    f(t, k4);
+    for (int i = 0; i < 3; i++) {
+        s[i] += h / 6.0f * (k1[i] + 2.0f * k2[i] + 2.0f * k3[i] + k4[i]);
+    }
+}
+
+// Attractor time units (map iterations for the logistic map) per second at
+// 1 Hz, chosen so each one wanders at roughly the old 0.5 Hz chaos rate
+const float ATTRACTOR_SPEEDS[OBFModule::NUM_ATTRACTORS] = {0.5f, 3.0f, 2.0f};
+
+// Largest RK4 step; longer control blocks are split into substeps
+const float MAX_STEP = 0.01f;
+
+// LFO cycles per clock pulse, spread across the Fréq knob; 1 Hz is 1:1
+const float CLOCK_RATIOS[OBFModule::NUM_CLOCK_RATIOS] = {
+    1.0f / 16.0f, 1.0f / 8.0f, 1.0f / 4.0f, 1.0f / 3.0f, 1.0f / 2.0f, 2.0f / 3.0f, 3.0f / 4.0f,
+    1.0f, 3.0f / 2.0f, 2.0f, 3.0f, 4.0f, 6.0f, 8.0f
+};
+
+} // namespace
+
 OBFModule::OBFModule() {
     config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS);
     configParam(FREQUENCY_PARAM, 0.1f, 10.0f, 1.0f, "Frequency", " Hz");
     configParam(CHAOS_PARAM, 0.0f, 1.0f, 0.0f, "Chaos", "%", 0.f, 100.f);
     configInput(GATE_INPUT, "Gate In");
+    configInput(CLOCK_INPUT, "Clock");
     configOutput(SINE_OUTPUT, "Sine LFO");
     configOutput(GATE_OUTPUT, "Gate Out");
+    configOutput(XYZ_OUTPUT, "Attractor X/Y/Z");
+    setSeed(random::u64());
 }
 
-void OBFModule::process(const ProcessArgs& args) {
+json_t* OBFModule::dataToJson() {
+    json_t* rootJ = json_object();
+    mpdsp::seedToJson(rootJ, rng, id);
+    json_object_set_new(rootJ, "blockSize", json_integer(blockSizeIndex));
+    json_object_set_new(rootJ, "interpolation", json_integer(interpolation));
+    json_object_set_new(rootJ, "attractor", json_integer(attractor));
+    json_object_set_new(rootJ, "resetOnGate", json_boolean(resetOnGate));
+    return rootJ;
+}
+
+void OBFModule::dataFromJson(json_t* rootJ) {
+    uint64_t seed;
+    if (mpdsp::seedFromJson(rootJ, id, &seed)) {
+        setSeed(seed);
+    }
+
+    json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+    if (blockSizeJ) {
+        setBlockSize((int)json_integer_value(blockSizeJ));
+    }
+
+    json_t* interpolationJ = json_object_get(rootJ, "interpolation");
+    if (interpolationJ) {
+        interpolation = rack::math::clamp((int)json_integer_value(interpolationJ), 0, NUM_INTERPOLATIONS - 1);
+    }
+
+    json_t* attractorJ = json_object_get(rootJ, "attractor");
+    if (attractorJ) {
+        setAttractor((int)json_integer_value(attractorJ));
+    }
+
+    json_t* resetOnGateJ = json_object_get(rootJ, "resetOnGate");
+    if (resetOnGateJ) {
+        resetOnGate = json_is_true(resetOnGateJ);
+    }
+}
+
+void OBFModule::setSeed(uint64_t seed) {
+    rng.setSeed(seed);
+    resetAttractor();
+}
+
+void OBFModule::setAttractor(int index) {
+    attractor = rack::math::clamp(index, 0, NUM_ATTRACTORS - 1);
+    resetAttractor();
+}
+
+void OBFModule::requestAttractor(int index) {
+    requestedAttractor.store(rack::math::clamp(index, 0, NUM_ATTRACTORS - 1));
+}
+
+void OBFModule::resetAttractor() {
+    // Seeded starting point, so every instance follows its own trajectory
+    for (int i = 0; i < 3; i++) {
+        attractorState[i] = 1.0f + rng.uniform();
+    }
+    for (int i = 0; i < 4; i++) {
+        logisticHistory[i] = 0.1f + 0.8f * rng.uniform();
+    }
+    logisticPhase = 0.0f;
+
+    // Let the flows settle onto the attractor before they are heard
+    if (attractor != ATTRACTOR_LOGISTIC) {
+        stepAttractor(5.0f);
+    }
+    chaosTo = readAttractor();
+    chaosFrom = chaosTo;
+}
+
+void OBFModule::stepAttractor(float time) {
+    if (attractor == ATTRACTOR_LOGISTIC) {
+        logisticPhase += time;
+        while (logisticPhase >= 1.0f) {
+            logisticPhase -= 1.0f;
+            float x = logisticHistory[0];
+            for (int i = 3; i > 0; i--) {
+                logisticHistory[i] = logisticHistory[i - 1];
+            }
+            logisticHistory[0] = 3.9f * x * (1.0f - x);
+        }
+        // 0 and 1 are fixed points of the map
+        if (!(logisticHistory[0] > 0.0f && logisticHistory[0] < 1.0f)) {
+            resetAttractor();
+        }
+        return;
+    }
+
+    int steps = (int)std::ceil(time / MAX_STEP);
+    float h = time / (float)steps;
+    void (*f)(const float*, float*) = (attractor == ATTRACTOR_LORENZ) ? lorenz : rossler;
+    for (int i = 0; i < steps; i++) {
+        rk4(f, attractorState, h);
+    }
+
+    // Restart rather than let a numerical blow-up reach the outputs
+    for (int i = 0; i < 3; i++) {
+        if (!std::isfinite(attractorState[i]) || std::fabs(attractorState[i]) > 1000.0f) {
+            resetAttractor();
+            return;
+        }
+    }
+}
+
+rack::simd::float_4 OBFModule::readAttractor() const {
+    const float* s = attractorState;
+    rack::simd::float_4 v;
+    switch (attractor) {
+        case ATTRACTOR_LORENZ:
+            v = rack::simd::float_4(s[0] / 20.0f, s[1] / 27.0f, (s[2] - 25.0f) / 25.0f, 0.0f);
+            break;
+        case ATTRACTOR_ROSSLER:
+            v = rack::simd::float_4(s[0] / 11.0f, s[1] / 11.0f, s[2] / 10.0f - 1.0f, 0.0f);
+            break;
+        default: {
+            // X, Y and Z are successive map values, crossfaded as the map ticks
+            const float* h = logisticHistory;
+            float t = logisticPhase;
+            v = rack::simd::float_4(h[1] + (h[0] - h[1]) * t, h[2] + (h[1] - h[2]) * t, h[3] + (h[2] - h[3]) * t, 0.5f);
+            v = 2.0f * v - 1.0f;
+        } break;
+    }
+    return rack::simd::clamp(v, -1.0f, 1.0f);
+}
+
+void OBFModule::setBlockSize(int index) {
+    blockSizeIndex = rack::math::clamp(index, 0, NUM_BLOCK_SIZES - 1);
+    // Takes effect at the next block boundary
+}
+
+float OBFModule::getClockRatio() {
+    // Same log mapping as the knob's 0.1-10 Hz range
+    float freq = params[FREQUENCY_PARAM].getValue();
+    float t = std::log(freq / 0.1f) / std::log(100.0f);
+    int index = (int)std::round(t * (NUM_CLOCK_RATIOS - 1));
+    return CLOCK_RATIOS[rack::math::clamp(index, 0, NUM_CLOCK_RATIOS - 1)];
+}
+
+void OBFModule::processClockEdge() {
+    if (clockSeen) {
+        clockPeriod = samplesSinceClock;
+    }
+    clockSeen = true;
+    samplesSinceClock = 0;
+    beatCount++;
+    if (clockPeriod <= 0) return;
+
+    float ratio = getClockRatio();
+    syncIncrement = ratio / (float)clockPeriod;
+
+    // Where the LFO should be on this pulse; the error is removed gradually
+    // over one beat, or one LFO cycle for ratios below 1:1, so the output
+    // never jumps and the increment stays positive
+    double target = (double)beatCount * (double)ratio;
+    target -= std::floor(target);
+    float error = (float)target - phase;
+    error -= std::round(error);
+    syncCorrection = error / ((float)clockPeriod * std::max(1.0f, 1.0f / ratio));
+}
+
+void OBFModule::beginBlock(const ProcessArgs& args) {
+    blockSize = 16 << blockSizeIndex;
+    blockStep = 1.0f / (float)blockSize;
+
+    int requested = requestedAttractor.exchange(-1);
+    if (requested >= 0) {
+        setAttractor(requested);
+    }
+
     float baseFreq = params[FREQUENCY_PARAM].getValue();
     float chaosAmount = params[CHAOS_PARAM].getValue();
     
@@ -26,16 +240,19 @@ void OBFModule::process(const ProcessArgs& args) {
         }
     }
 
-    // Generate smooth random modulation (update chaos phase slowly)
-    float chaosFreq = 0.5f; // Chaos LFO runs at 0.5 Hz
-    sampleTimer += chaosFreq * args.sampleTime;
-    while (sampleTimer >= 1.0f) {
-        sampleTimer -= 1.0f;
+    // process() drops the period once the clock stops for two periods
+    bool locked = clockPeriod > 0;
+    if (locked) {
+        baseFreq = syncIncrement * args.sampleRate;
     }
-    
-    // Use sine wave of random phase for smooth random-like modulation
-    float chaosPhase = sampleTimer + ((float)(rng & 0xFFFF) / 65536.0f);
-    chaosValue = sinf(2.0f * M_PI * chaosPhase);
+
+    // Advance the attractor over the block that just ended; its X drives
+    // the modulation
+    float blockTime = args.sampleTime * (float)blockElapsed;
+    stepAttractor(blockTime * baseFreq * ATTRACTOR_SPEEDS[attractor]);
+    chaosFrom = chaosTo;
+    chaosTo = readAttractor();
+    chaosValue = chaosTo[0];
     
     // Apply chaos: smoothly modulate frequency
     // At chaos=0: no modulation (multiplier = 1)
@@ -45,19 +262,97 @@ void OBFModule::process(const ProcessArgs& args) {
     
     // Clamp to positive values
     if (modulatedFreq < 0.01f) modulatedFreq = 0.01f;
+    phaseIncrement = modulatedFreq * args.sampleTime;
+    if (locked) {
+        phaseIncrement = std::max(phaseIncrement + syncCorrection, 0.0f);
+    }
+
+    // Sine at both ends of the block
+    float span = phaseIncrement * (float)blockSize;
+    float s0 = sinf(2.0f * M_PI * phase);
+    float s1 = sinf(2.0f * M_PI * (phase + span));
+    if (interpolation == INTERP_CUBIC) {
+        // Hermite segment using the exact slopes of the sine at both ends
+        float d0 = 2.0f * M_PI * span * cosf(2.0f * M_PI * phase);
+        float d1 = 2.0f * M_PI * span * cosf(2.0f * M_PI * (phase + span));
+        blockCoeffs[0] = s0;
+        blockCoeffs[1] = d0;
+        blockCoeffs[2] = 3.0f * (s1 - s0) - 2.0f * d0 - d1;
+        blockCoeffs[3] = 2.0f * (s0 - s1) + d0 + d1;
+    }
+    else {
+        blockCoeffs[0] = s0;
+        blockCoeffs[1] = s1 - s0;
+        blockCoeffs[2] = 0.0f;
+        blockCoeffs[3] = 0.0f;
+    }
+}
+
+void OBFModule::process(const ProcessArgs& args) {
+    // A reset or clock edge starts a new control block right away so the
+    // output segment follows the corrected phase
+    bool restart = false;
+    if (resetOnGate && resetTrigger.process(inputs[GATE_INPUT].getVoltage())) {
+        phase = 0.0f;
+        // A clock pulse arriving with the reset is beat 0
+        beatCount = -1;
+        syncCorrection = 0.0f;
+        restart = true;
+    }
+    if (inputs[CLOCK_INPUT].isConnected()) {
+        samplesSinceClock++;
+        // A clock stalled for more than two periods is forgotten, so the gap
+        // is never measured as a period; the first fresh edge is beat 0 and
+        // the lock returns on the second
+        if (clockPeriod > 0 && samplesSinceClock > 2 * clockPeriod) {
+            clockSeen = false;
+            clockPeriod = 0;
+            beatCount = -1;
+        }
+        if (clockTrigger.process(inputs[CLOCK_INPUT].getVoltage())) {
+            processClockEdge();
+            restart = clockPeriod > 0;
+        }
+    }
+    else if (clockSeen) {
+        clockSeen = false;
+        clockPeriod = 0;
+        beatCount = -1;
+    }
+    if (restart && blockCounter > 0) {
+        blockElapsed = blockCounter;
+        blockCounter = 0;
+    }
+
+    if (blockCounter == 0) {
+        beginBlock(args);
+    }
+    blockCounter++;
+    float t = (float)blockCounter * blockStep;
+    if (blockCounter >= blockSize) {
+        blockElapsed = blockSize;
+        blockCounter = 0;
+    }
     
     // Update phase with modulated frequency
-    phase += modulatedFreq * args.sampleTime;
+    phase += phaseIncrement;
     while (phase >= 1.0f) {
         phase -= 1.0f;
     }
     
     // Output sine wave
-    float sine = sinf(2.0f * M_PI * phase);
+    float sine = ((blockCoeffs[3] * t + blockCoeffs[2]) * t + blockCoeffs[1]) * t + blockCoeffs[0];
     outputs[SINE_OUTPUT].setVoltage(5.0f * sine);
     
-    // Gate output: high when sine >= 0 (max at +5V), low when sine < 0 (min at -5V)
-    bool gateHigh = sine >= 0.0f;
+    // Gate output: high over the positive half of the sine (max at +5V), low
+    // over the negative half. Taken from the per-sample phase so edges land on
+    // the exact sample even inside a control block
+    bool gateHigh = phase <= 0.5f;
     outputs[GATE_OUTPUT].setVoltage(gateHigh ? 10.0f : 0.0f);
     lastGateHigh = gateHigh;
+
+    if (outputs[XYZ_OUTPUT].isConnected()) {
+        outputs[XYZ_OUTPUT].setChannels(3);
+        outputs[XYZ_OUTPUT].setVoltageSimd(5.0f * (chaosFrom + (chaosTo - chaosFrom) * t), 0);
+    }
 }
\ No newline at end of file
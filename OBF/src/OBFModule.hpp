@@ -1,5 +1,6 @@
 #pragma once
 #include "rack.hpp"
+#include "mpdsp/RandomStream.hpp"
 
 struct OBFModule : rack::Module {
     enum ParamIds {
@@ -9,20 +10,83 @@ struct OBFModule : rack::Module {
     };
     enum InputIds {
         GATE_INPUT,
+        CLOCK_INPUT,
         NUM_INPUTS
     };
     enum OutputIds {
         SINE_OUTPUT,
         GATE_OUTPUT,
+        XYZ_OUTPUT,
         NUM_OUTPUTS
     };
+    enum Attractor {
+        ATTRACTOR_LORENZ,
+        ATTRACTOR_ROSSLER,
+        ATTRACTOR_LOGISTIC,
+        NUM_ATTRACTORS
+    };
+    enum Interpolation {
+        INTERP_LINEAR,
+        INTERP_CUBIC,
+        NUM_INTERPOLATIONS
+    };
+
+    // The LFO shape is evaluated once per control block and interpolated in
+    // between; the phase itself still advances every sample
+    static const int NUM_BLOCK_SIZES = 3;
+    int blockSizeIndex = 1; // 16, 32 or 64 samples
+    int interpolation = INTERP_CUBIC;
+    int blockCounter = 0;
+    int blockSize = 32;
+    int blockElapsed = 32;  // Length of the block that just ended
+    float phaseIncrement = 0.0f;
+    float blockStep = 0.0f;  // 1 / blockSize
+    float blockCoeffs[4] = {}; // Output polynomial over the block, t in (0, 1]
+
+    // Chaotic source, stepped once per control block. The outputs and the
+    // frequency modulation use its state normalized to -1..1, interpolated
+    // from the previous block's value to this one's
+    int attractor = ATTRACTOR_LORENZ;
+    // Picked from the menu on the UI thread, -1 when nothing is pending;
+    // beginBlock() switches to it so the state is never rewritten mid-step
+    std::atomic<int> requestedAttractor{-1};
+    float attractorState[3] = {};
+    float logisticHistory[4] = {}; // Newest first
+    float logisticPhase = 0.0f;
+    rack::simd::float_4 chaosFrom = 0.0f;
+    rack::simd::float_4 chaosTo = 0.0f;
+
+    // Clock sync: while a clock is patched the Fréq knob selects a ratio of
+    // the measured clock rate. Everything is worked out on clock edges;
+    // between edges only the sample counter advances
+    static const int NUM_CLOCK_RATIOS = 14;
+    rack::dsp::SchmittTrigger clockTrigger;
+    rack::dsp::SchmittTrigger resetTrigger;
+    bool resetOnGate = false;
+    bool clockSeen = false;
+    int64_t samplesSinceClock = 0;
+    int64_t clockPeriod = 0;      // Samples between the last two edges, 0 until measured
+    int64_t beatCount = -1;       // The first edge after a load, reset or unplug is beat 0
+    float syncIncrement = 0.0f;   // Phase increment at the locked ratio
+    float syncCorrection = 0.0f;  // Extra increment that removes the phase error
 
     float phase = 0.0f;
     float chaosValue = 0.0f;
-    float sampleTimer = 0.0f;
-    uint32_t rng = 12345u;
+    mpdsp::RandomStream rng;
     bool lastGateHigh = false;
 
     OBFModule();
     void process(const ProcessArgs& args) override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void setSeed(uint64_t seed);
+    void setBlockSize(int index);
+    void beginBlock(const ProcessArgs& args);
+    void processClockEdge();
+    float getClockRatio();
+    void setAttractor(int index);
+    void requestAttractor(int index);
+    void resetAttractor();
+    void stepAttractor(float time);
+    rack::simd::float_4 readAttractor() const;
 };;
\ No newline at end of file
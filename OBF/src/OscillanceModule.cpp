@@ -1,63 +1,130 @@
-#include "OBFModule.hpp"
+#include "OscillanceModule.hpp"
 #include <cmath>
-#include <random>
 
 using namespace rack;
 
-OBFModule::OBFModule() {
+OscillanceModule::OscillanceModule() {
     config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS);
     configParam(FREQUENCY_PARAM, 0.1f, 10.0f, 1.0f, "Frequency", " Hz");
+    configParam(SPREAD_PARAM, 0.0f, 1.0f, 1.0f, "Spread", "%", 0.f, 100.f);
     configParam(CHAOS_PARAM, 0.0f, 1.0f, 0.0f, "Chaos", "%", 0.f, 100.f);
-    configInput(GATE_INPUT, "Gate In");
-    configOutput(SINE_OUTPUT, "Sine LFO");
-    configOutput(GATE_OUTPUT, "Gate Out");
+    configInput(RESET_INPUT, "Reset");
+    configOutput(SINE_OUTPUT, "Sine LFOs");
+    configOutput(GATE_OUTPUT, "Gates");
+    setSeed(random::u64());
+    onReset();
 }
 
-void OBFModule::process(const ProcessArgs& args) {
+void OscillanceModule::onReset() {
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        phases[g].reset();
+        phaseIncrements[g] = 0.0f;
+        phaseOffsets[g] = 0.0f;
+    }
+    blockCounter = 0;
+}
+
+json_t* OscillanceModule::dataToJson() {
+    json_t* rootJ = json_object();
+    mpdsp::seedToJson(rootJ, rng, id);
+    json_object_set_new(rootJ, "channels", json_integer(channels));
+    json_object_set_new(rootJ, "spreadMode", json_integer(spreadMode));
+    return rootJ;
+}
+
+void OscillanceModule::dataFromJson(json_t* rootJ) {
+    uint64_t seed;
+    if (mpdsp::seedFromJson(rootJ, id, &seed)) {
+        setSeed(seed);
+    }
+
+    json_t* channelsJ = json_object_get(rootJ, "channels");
+    if (channelsJ) {
+        channels = rack::math::clamp((int)json_integer_value(channelsJ), 1, MAX_CHANNELS);
+    }
+
+    json_t* spreadModeJ = json_object_get(rootJ, "spreadMode");
+    if (spreadModeJ) {
+        spreadMode = rack::math::clamp((int)json_integer_value(spreadModeJ), 0, NUM_SPREAD_MODES - 1);
+    }
+}
+
+void OscillanceModule::setSeed(uint64_t seed) {
+    rng.setSeed(seed);
+    chaosPhase = 0.0f;
+    drawChaosTargets();
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        chaosFrom[g] = chaosTo[g];
+    }
+}
+
+void OscillanceModule::drawChaosTargets() {
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        chaosTo[g] = 2.0f * rng.uniform4() - 1.0f;
+    }
+}
+
+void OscillanceModule::beginBlock(const ProcessArgs& args) {
     float baseFreq = params[FREQUENCY_PARAM].getValue();
+    float spread = params[SPREAD_PARAM].getValue();
     float chaosAmount = params[CHAOS_PARAM].getValue();
-    
-    // Gate input controls whether chaos is active
-    bool gateInputConnected = inputs[GATE_INPUT].isConnected();
-    if (gateInputConnected) {
-        float gateVoltage = inputs[GATE_INPUT].getVoltage();
-        if (gateVoltage < 1.0f) {
-            chaosAmount = 0.0f; // Disable chaos when gate is low
+
+    // Chaos targets change every two seconds, eased in with a smoothstep
+    float chaosFreq = 0.5f;
+    chaosPhase += chaosFreq * args.sampleTime * (float)BLOCK_SIZE;
+    if (chaosPhase >= 1.0f) {
+        chaosPhase -= 1.0f;
+        for (int g = 0; g < NUM_GROUPS; g++) {
+            chaosFrom[g] = chaosTo[g];
         }
+        drawChaosTargets();
     }
+    float ease = chaosPhase * chaosPhase * (3.0f - 2.0f * chaosPhase);
+
+    float phaseStep = spread / (float)channels;
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        simd::float_4 lane = simd::float_4(0.0f, 1.0f, 2.0f, 3.0f) + (float)(g * 4);
+
+        simd::float_4 freq = baseFreq;
+        if (spreadMode == SPREAD_RATIO) {
+            freq *= 1.0f + spread * lane;
+            phaseOffsets[g] = 0.0f;
+        }
+        else {
+            phaseOffsets[g] = lane * phaseStep;
+        }
 
-    // Generate smooth random modulation (update chaos phase slowly)
-    float chaosFreq = 0.5f; // Chaos LFO runs at 0.5 Hz
-    sampleTimer += chaosFreq * args.sampleTime;
-    while (sampleTimer >= 1.0f) {
-        sampleTimer -= 1.0f;
-    }
-    
-    // Use sine wave of random phase for smooth random-like modulation
-    float chaosPhase = sampleTimer + ((float)(rng & 0xFFFF) / 65536.0f);
-    chaosValue = sinf(2.0f * M_PI * chaosPhase);
-    
-    // Apply chaos: smoothly modulate frequency
-    // At chaos=0: no modulation (multiplier = 1)
-    // At chaos=1: ±300% modulation (multiplier = -2 to 4)
-    float freqMultiplier = 1.0f + (chaosValue * chaosAmount * 3.0f);
-    float modulatedFreq = baseFreq * freqMultiplier;
-    
-    // Clamp to positive values
-    if (modulatedFreq < 0.01f) modulatedFreq = 0.01f;
-    
-    // Update phase with modulated frequency
-    phase += modulatedFreq * args.sampleTime;
-    while (phase >= 1.0f) {
-        phase -= 1.0f;
-    }
-    
-    // Output sine wave
-    float sine = sinf(2.0f * M_PI * phase);
-    outputs[SINE_OUTPUT].setVoltage(5.0f * sine);
-    
-    // Gate output: high when sine >= 0 (max at +5V), low when sine < 0 (min at -5V)
-    bool gateHigh = sine >= 0.0f;
-    outputs[GATE_OUTPUT].setVoltage(gateHigh ? 10.0f : 0.0f);
-    lastGateHigh = gateHigh;
-}
\ No newline at end of file
+        // Same ±300% range as OBF's chaos
+        simd::float_4 chaosValue = chaosFrom[g] + (chaosTo[g] - chaosFrom[g]) * ease;
+        freq *= 1.0f + chaosValue * (chaosAmount * 3.0f);
+        freq = simd::fmax(freq, 0.01f);
+        phaseIncrements[g] = freq * args.sampleTime;
+    }
+}
+
+void OscillanceModule::process(const ProcessArgs& args) {
+    if (blockCounter == 0) {
+        beginBlock(args);
+    }
+    if (++blockCounter >= BLOCK_SIZE) {
+        blockCounter = 0;
+    }
+
+    if (resetTrigger.process(inputs[RESET_INPUT].getVoltage())) {
+        for (int g = 0; g < NUM_GROUPS; g++) {
+            phases[g].reset();
+        }
+    }
+
+    int groups = (channels + 3) / 4;
+    outputs[SINE_OUTPUT].setChannels(channels);
+    outputs[GATE_OUTPUT].setChannels(channels);
+    for (int g = 0; g < groups; g++) {
+        simd::float_4 phase = phases[g].process(phaseIncrements[g]) + phaseOffsets[g];
+        phase -= simd::floor(phase);
+
+        // Gates are high over the positive half of each sine
+        outputs[SINE_OUTPUT].setVoltageSimd(5.0f * mpdsp::sin2piFast(phase), g * 4);
+        outputs[GATE_OUTPUT].setVoltageSimd(simd::ifelse(phase < 0.5f, 10.0f, 0.0f), g * 4);
+    }
+}
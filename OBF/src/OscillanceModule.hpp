@@ -1,14 +1,20 @@
 #pragma once
 #include "rack.hpp"
+#include "mpdsp/Phasor.hpp"
+#include "mpdsp/RandomStream.hpp"
+#include "mpdsp/FastMath.hpp"
 
-struct OBFModule : rack::Module {
+// Bank of up to 16 slow sine LFOs on one polyphonic output, computed four
+// lanes at a time
+struct OscillanceModule : rack::Module {
     enum ParamIds {
         FREQUENCY_PARAM,
+        SPREAD_PARAM,
         CHAOS_PARAM,
         NUM_PARAMS
     };
     enum InputIds {
-        GATE_INPUT,
+        RESET_INPUT,
         NUM_INPUTS
     };
     enum OutputIds {
@@ -16,13 +22,40 @@ struct OBFModule : rack::Module {
         GATE_OUTPUT,
         NUM_OUTPUTS
     };
+    enum SpreadMode {
+        SPREAD_PHASE, // Same frequency, phases spread across the cycle
+        SPREAD_RATIO, // Frequencies at 1, 1 + s, 1 + 2s, ... times the base
+        NUM_SPREAD_MODES
+    };
+
+    static const int MAX_CHANNELS = 16;
+    static const int NUM_GROUPS = MAX_CHANNELS / 4;
+    // Frequencies, offsets and chaos are refreshed once per block
+    static const int BLOCK_SIZE = 32;
+
+    int channels = MAX_CHANNELS;
+    int spreadMode = SPREAD_PHASE;
+    int blockCounter = 0;
+
+    mpdsp::Phasor<rack::simd::float_4> phases[NUM_GROUPS];
+    rack::simd::float_4 phaseIncrements[NUM_GROUPS];
+    rack::simd::float_4 phaseOffsets[NUM_GROUPS];
+
+    // Per-lane chaos: a smoothed walk between random targets, one per lane,
+    // drawn every two seconds
+    rack::simd::float_4 chaosFrom[NUM_GROUPS];
+    rack::simd::float_4 chaosTo[NUM_GROUPS];
+    float chaosPhase = 0.0f;
+    mpdsp::RandomStream rng;
 
-    float phase = 0.0f;
-    float chaosValue = 0.0f;
-    float sampleTimer = 0.0f;
-    uint32_t rng = 12345u;
-    bool lastGateHigh = false;
+    rack::dsp::SchmittTrigger resetTrigger;
 
-    OBFModule();
+    OscillanceModule();
     void process(const ProcessArgs& args) override;
-};;
\ No newline at end of file
+    void onReset() override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void setSeed(uint64_t seed);
+    void drawChaosTargets();
+    void beginBlock(const ProcessArgs& args);
+};
@@ -1,9 +1,13 @@
 #include "plugin.hpp"
 #include "OBFModule.hpp"
+#include "OscillanceModule.hpp"
 
 using namespace rack;
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin *pluginInstance;
+#endif
 
 	struct OBFModuleWidget : ModuleWidget {
 		OBFModuleWidget(OBFModule *module) {
@@ -33,6 +37,15 @@ Plugin *pluginInstance;
 			freqLabel->color = nvgRGB(180, 180, 180);
 			addChild(freqLabel);
 
+			// Horloge label (French for clock)
+			auto clockLabel = createWidget<ui::Label>(Vec(2, 134));
+			clockLabel->box.size.x = box.size.x;
+			clockLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			clockLabel->text = "Horloge";
+			clockLabel->fontSize = 10;
+			clockLabel->color = nvgRGB(180, 180, 180);
+			addChild(clockLabel);
+
 			// Chaos label
 			auto chaosLabel = createWidget<ui::Label>(Vec(5.7, 181));
 			chaosLabel->box.size.x = box.size.x;
@@ -42,6 +55,15 @@ Plugin *pluginInstance;
 			chaosLabel->color = nvgRGB(180, 180, 180);
 			addChild(chaosLabel);
 
+			// XYZ label (polyphonic attractor output)
+			auto xyzLabel = createWidget<ui::Label>(Vec(2, 219));
+			xyzLabel->box.size.x = box.size.x;
+			xyzLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			xyzLabel->text = "XYZ";
+			xyzLabel->fontSize = 11;
+			xyzLabel->color = nvgRGB(180, 180, 180);
+			addChild(xyzLabel);
+
 			// Entrée label (French for input)
 			auto gateInLabel = createWidget<ui::Label>(Vec(2, 249));
 			gateInLabel->box.size.x = box.size.x;
@@ -71,14 +93,139 @@ Plugin *pluginInstance;
 			addChild(sineLabel);
 
 			addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(10.16, 30.48)), module, OBFModule::FREQUENCY_PARAM));
+			addInput(createInputCentered<PJ301MPort>(mm2px(Vec(10.16, 42.3)), module, OBFModule::CLOCK_INPUT));
 			addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(10.16, 55.8)), module, OBFModule::CHAOS_PARAM));
+			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(10.16, 71.0)), module, OBFModule::XYZ_OUTPUT));
 			addInput(createInputCentered<PJ301MPort>(mm2px(Vec(10.16, 81.0)), module, OBFModule::GATE_INPUT));
 			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(10.16, 94.7)), module, OBFModule::GATE_OUTPUT));
 			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(10.16, 108.41)), module, OBFModule::SINE_OUTPUT));
 		}
+
+		void appendContextMenu(Menu *menu) override {
+			OBFModule *module = dynamic_cast<OBFModule*>(this->module);
+			if (!module) return;
+
+			menu->addChild(new MenuSeparator);
+			menu->addChild(createIndexSubmenuItem("Control rate", {"16 samples", "32 samples", "64 samples"},
+				[=]() { return (size_t)module->blockSizeIndex; },
+				[=](size_t index) { module->setBlockSize((int)index); }
+			));
+			menu->addChild(createIndexPtrSubmenuItem("Interpolation", {"Linear", "Cubic"}, &module->interpolation));
+			menu->addChild(createIndexSubmenuItem("Attractor", {"Lorenz", "Rössler", "Logistic map"},
+				[=]() {
+					int requested = module->requestedAttractor.load();
+					return (size_t)(requested >= 0 ? requested : module->attractor);
+				},
+				[=](size_t index) { module->requestAttractor((int)index); }
+			));
+			menu->addChild(createBoolPtrMenuItem("Gate input resets phase", "", &module->resetOnGate));
+		}
 	};Model *modelOBFModule = createModel<OBFModule, OBFModuleWidget>("OBFModule");
 
+	struct OscillanceWidget : ModuleWidget {
+		OscillanceWidget(OscillanceModule *module) {
+			setModule(module);
+			setPanel(createPanel(asset::plugin(pluginInstance, "res/Oscillance.svg")));
+
+			addChild(createWidget<ScrewSilver>(Vec(RACK_GRID_WIDTH, 0)));
+			addChild(createWidget<ScrewSilver>(Vec(box.size.x - 2 * RACK_GRID_WIDTH, 0)));
+			addChild(createWidget<ScrewSilver>(Vec(RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
+			addChild(createWidget<ScrewSilver>(Vec(box.size.x - 2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
+
+			// Title label - matching OBF
+			auto titleLabel = createWidget<ui::Label>(Vec(0, 15));
+			titleLabel->box.size.x = box.size.x;
+			titleLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			titleLabel->text = "OSC16";
+			titleLabel->fontSize = 13;
+			titleLabel->color = nvgRGB(255, 255, 255);
+			addChild(titleLabel);
+
+			// Fréq label
+			auto freqLabel = createWidget<ui::Label>(Vec(2, 90));
+			freqLabel->box.size.x = box.size.x;
+			freqLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			freqLabel->text = "Fréq";
+			freqLabel->fontSize = 11;
+			freqLabel->color = nvgRGB(180, 180, 180);
+			addChild(freqLabel);
+
+			// Écart label (spread)
+			auto spreadLabel = createWidget<ui::Label>(Vec(2, 149));
+			spreadLabel->box.size.x = box.size.x;
+			spreadLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			spreadLabel->text = "Écart";
+			spreadLabel->fontSize = 11;
+			spreadLabel->color = nvgRGB(180, 180, 180);
+			addChild(spreadLabel);
+
+			// Chaos label
+			auto chaosLabel = createWidget<ui::Label>(Vec(2, 208));
+			chaosLabel->box.size.x = box.size.x;
+			chaosLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			chaosLabel->text = "Chaos";
+			chaosLabel->fontSize = 11;
+			chaosLabel->color = nvgRGB(180, 180, 180);
+			addChild(chaosLabel);
+
+			// Réinit label (reset)
+			auto resetLabel = createWidget<ui::Label>(Vec(2, 249));
+			resetLabel->box.size.x = box.size.x;
+			resetLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			resetLabel->text = "Réinit";
+			resetLabel->fontSize = 11;
+			resetLabel->color = nvgRGB(180, 180, 180);
+			addChild(resetLabel);
+
+			// Portes label (poly gates)
+			auto gateOutLabel = createWidget<ui::Label>(Vec(2, 289));
+			gateOutLabel->box.size.x = box.size.x;
+			gateOutLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			gateOutLabel->text = "Portes";
+			gateOutLabel->fontSize = 11;
+			gateOutLabel->color = nvgRGB(180, 180, 180);
+			addChild(gateOutLabel);
+
+			// Sorties label (poly sines)
+			auto sineLabel = createWidget<ui::Label>(Vec(2, 330));
+			sineLabel->box.size.x = box.size.x;
+			sineLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+			sineLabel->text = "Sorties";
+			sineLabel->fontSize = 11;
+			sineLabel->color = nvgRGB(180, 180, 180);
+			addChild(sineLabel);
+
+			addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(10.16, 25.0)), module, OscillanceModule::FREQUENCY_PARAM));
+			addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(10.16, 45.0)), module, OscillanceModule::SPREAD_PARAM));
+			addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(10.16, 65.0)), module, OscillanceModule::CHAOS_PARAM));
+			addInput(createInputCentered<PJ301MPort>(mm2px(Vec(10.16, 81.0)), module, OscillanceModule::RESET_INPUT));
+			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(10.16, 94.7)), module, OscillanceModule::GATE_OUTPUT));
+			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(10.16, 108.41)), module, OscillanceModule::SINE_OUTPUT));
+		}
+
+		void appendContextMenu(Menu *menu) override {
+			OscillanceModule *module = dynamic_cast<OscillanceModule*>(this->module);
+			if (!module) return;
+
+			std::vector<std::string> channelLabels;
+			for (int i = 1; i <= OscillanceModule::MAX_CHANNELS; i++) {
+				channelLabels.push_back(std::to_string(i));
+			}
+
+			menu->addChild(new MenuSeparator);
+			menu->addChild(createIndexSubmenuItem("Channels", channelLabels,
+				[=]() { return (size_t)(module->channels - 1); },
+				[=](size_t index) { module->channels = (int)index + 1; }
+			));
+			menu->addChild(createIndexPtrSubmenuItem("Spread", {"Phase", "Frequency ratio"}, &module->spreadMode));
+		}
+	};
+Model *modelOscillance = createModel<OscillanceModule, OscillanceWidget>("Oscillance");
+
+#ifndef COMBINED_PLUGIN
 void init(Plugin *p) {
 	pluginInstance = p;
 	p->addModel(modelOBFModule);
-}
\ No newline at end of file
+	p->addModel(modelOscillance);
+}
+#endif
@@ -1,9 +1,37 @@
 #include "OscillateurTritoniqueModule.hpp"
 #include <cmath>
 
+namespace {
+
+// Topology frames: 0 = sine, 1 = saw, 2 = folded sine. Crossfading
+// neighbours gives the sine → saw → folded morph
+struct TopologyFrames : OscillateurTritoniqueModule::TopologyBank {
+    TopologyFrames() : OscillateurTritoniqueModule::TopologyBank(3) {
+        const int size = OscillateurTritoniqueModule::WAVETABLE_SIZE;
+        for (int i = 0; i < size; i++) {
+            float phase = (float)i / size;
+            float sine = std::sin(2.f * M_PI * phase);
+            frame(0)[i] = sine;
+            frame(1)[i] = 2.f * phase - 1.f;
+            // Wavefold for complex topology
+            frame(2)[i] = std::sin(3.f * M_PI * phase) * 0.5f + sine * 0.5f;
+        }
+    }
+};
+
+const OscillateurTritoniqueModule::TopologyBank* getTopologyBank() {
+    static const TopologyFrames bank;
+    return &bank;
+}
+
+} // namespace
+
 OscillateurTritoniqueModule::OscillateurTritoniqueModule() {
     config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
     
+    topologyBank = getTopologyBank();
+    topologyCursor = topologyBank->locate(0.f);
+    
     configParam(TOPOLOGY_PARAM, 0.f, 1.f, 0.33f, "Topology Warp");
     configParam(TOPOLOGY_ATTEN_PARAM, -1.f, 1.f, 0.f, "Topology CV Attenuator");
     
@@ -16,192 +44,329 @@ OscillateurTritoniqueModule::OscillateurTritoniqueModule() {
     configParam(GLIDE_PARAM, 0.f, 1.f, 0.1f, "Tritone Glide");
     configParam(GLIDE_ATTEN_PARAM, -1.f, 1.f, 0.f, "Glide CV Attenuator");
     
+    configParam(UNISON_DETUNE_PARAM, 0.f, 1.f, 0.2f, "Unison Detune", " cents", 0.f, 50.f);
+    
     configInput(VOCT_INPUT, "V/Oct");
     configInput(TOPOLOGY_CV_INPUT, "Topology CV");
     configInput(SKEW_CV_INPUT, "Temporal Skew CV");
     configInput(BLOOM_CV_INPUT, "Spectral Bloom CV");
     configInput(GLIDE_CV_INPUT, "Glide CV");
     
-    configOutput(AUDIO_OUTPUT, "Audio");
+    configOutput(AUDIO_OUTPUT, "Audio (left/mono)");
+    configOutput(AUDIO_RIGHT_OUTPUT, "Audio (right)");
+    
+    topologyParam.config(TOPOLOGY_PARAM, TOPOLOGY_CV_INPUT, TOPOLOGY_ATTEN_PARAM);
+    skewParam.config(SKEW_PARAM, SKEW_CV_INPUT, SKEW_ATTEN_PARAM);
+    bloomParam.config(BLOOM_PARAM, BLOOM_CV_INPUT, BLOOM_ATTEN_PARAM);
+    applyQuality(mpdsp::resolveQuality(quality));
     
+    // The lines for the default rate are allocated here, off the engine
+    // thread; onSampleRateChange() only records a new size
+    for (int side = 0; side < 2; side++) {
+        for (int g = 0; g < MAX_VOICE_GROUPS; g++) {
+            skewLines[side][g].resize(skewLineSize(48000.f));
+        }
+    }
     onReset();
 }
 
+void OscillateurTritoniqueModule::onSampleRateChange(const SampleRateChangeEvent& e) {
+    configureSkew(e.sampleRate);
+}
+
+int OscillateurTritoniqueModule::skewLineSize(float sampleRate) {
+    return (int)((SKEW_MAX_DELAY + SKEW_MOD_DEPTH) * sampleRate) + 4;
+}
+
+void OscillateurTritoniqueModule::configureSkew(float sampleRate) {
+    // Runs on the engine thread, so a line that needs a new size hands its
+    // memory back and takes a zeroed block from the buffer pool later
+    for (int side = 0; side < 2; side++) {
+        for (int g = 0; g < MAX_VOICE_GROUPS; g++) {
+            skewLines[side][g].requestSize(skewLineSize(sampleRate));
+        }
+    }
+}
+
 void OscillateurTritoniqueModule::onReset() {
-    wavetablePhase = 0.f;
-    currentFreq = 261.626f;
-    targetFreq = 261.626f;
-    skewWriteIdx = 0;
+    skewMod.reset();
+    tritoneMod.reset();
+    for (int side = 0; side < 2; side++) {
+        for (int g = 0; g < MAX_VOICE_GROUPS; g++) {
+            skewLines[side][g].clear();
+        }
+    }
     
-    for (int i = 0; i < SKEW_BUFFER_SIZE; i++) {
-        skewBuffer[i] = 0.f;
+    for (int g = 0; g < MAX_VOICE_GROUPS; g++) {
+        wavetablePhases[g] = 0.f;
+        currentFreqs[g] = 261.626f; // C4
     }
     
-    for (int i = 0; i < NUM_HARMONICS; i++) {
-        harmonicPhases[i] = 0.f;
-        harmonicAmps[i] = 0.f;
+    for (int v = 0; v < MAX_VOICES; v++) {
+        for (int g = 0; g < NUM_HARMONIC_GROUPS; g++) {
+            harmonicPhases[v][g] = 0.f;
+        }
+        // Staggered start so the copies don't begin in phase
+        for (int g = 0; g < MAX_UNISON_GROUPS; g++) {
+            unisonPhases[v][g] = simd::float_4(0.f, 0.37f, 0.74f, 0.11f) + 0.48f * g;
+        }
     }
+    topologyParam.reset();
+    bloomParam.reset();
+    lastUnison = 0;
 }
 
-void OscillateurTritoniqueModule::generateWavetable(float topology) {
-    // Morph between sine → saw → folded sine
-    // topology: 0.0 = pure sine, 0.5 = sawtooth, 1.0 = folded/complex
+json_t* OscillateurTritoniqueModule::dataToJson() {
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "unison", json_integer(unison));
+    json_object_set_new(rootJ, "quality", json_integer(quality));
+    return rootJ;
+}
+
+void OscillateurTritoniqueModule::dataFromJson(json_t* rootJ) {
+    json_t* unisonJ = json_object_get(rootJ, "unison");
+    if (unisonJ) {
+        unison = clamp((int)json_integer_value(unisonJ), 1, MAX_UNISON);
+    }
     
-    for (int i = 0; i < WAVETABLE_SIZE; i++) {
-        float phase = (float)i / WAVETABLE_SIZE;
-        float sine = std::sin(2.f * M_PI * phase);
-        float saw = 2.f * phase - 1.f;
-        
-        // Wavefold for complex topology
-        float folded = std::sin(3.f * M_PI * phase) * 0.5f + sine * 0.5f;
-        
-        if (topology < 0.5f) {
-            // Morph sine → saw
-            float blend = topology * 2.f;
-            wavetable[i] = sine * (1.f - blend) + saw * blend;
-        } else {
-            // Morph saw → folded
-            float blend = (topology - 0.5f) * 2.f;
-            wavetable[i] = saw * (1.f - blend) + folded * blend;
-        }
+    json_t* qualityJ = json_object_get(rootJ, "quality");
+    if (qualityJ) {
+        quality = clamp((int)json_integer_value(qualityJ), mpdsp::QUALITY_DEFAULT, mpdsp::NUM_QUALITIES - 1);
     }
 }
 
-float OscillateurTritoniqueModule::processTopologyWarp(float topology, float phase) {
-    // Sample from wavetable
-    float readPos = phase * WAVETABLE_SIZE;
-    int idx0 = (int)readPos % WAVETABLE_SIZE;
-    int idx1 = (idx0 + 1) % WAVETABLE_SIZE;
-    float frac = readPos - (int)readPos;
-    
-    // Linear interpolation
-    return wavetable[idx0] * (1.f - frac) + wavetable[idx1] * frac;
+void OscillateurTritoniqueModule::applyQuality(int tier) {
+    // Eco drops the top four bloom partials, reads the skew lines linearly
+    // and reads knobs half as often; High reads them twice as often
+    static const int HARMONIC_GROUP_COUNTS[mpdsp::NUM_QUALITIES] = {NUM_HARMONIC_GROUPS - 1, NUM_HARMONIC_GROUPS, NUM_HARMONIC_GROUPS};
+    static const int CONTROL_BLOCK_SIZES[mpdsp::NUM_QUALITIES] = {64, 32, 16};
+    appliedQuality = tier;
+    activeHarmonicGroups = HARMONIC_GROUP_COUNTS[tier];
+    cubicSkew = (tier != mpdsp::QUALITY_ECO);
+    controlDivider.setDivision(CONTROL_BLOCK_SIZES[tier]);
 }
 
-float OscillateurTritoniqueModule::processTemporalSkew(float input, float skew, float sampleTime) {
-    // Write to circular buffer
-    skewBuffer[skewWriteIdx] = input;
-    skewWriteIdx = (skewWriteIdx + 1) % SKEW_BUFFER_SIZE;
+simd::float_4 OscillateurTritoniqueModule::processTopologyWarp(simd::float_4 phase) {
+    // Sample the morphed wavetable, one lookup per voice
+    return TopologyBank::read(topologyCursor, phase);
+}
+
+void OscillateurTritoniqueModule::processTemporalSkew(simd::float_4* left, simd::float_4* right, int groups, float skew, float sampleTime) {
+    // After a sample rate change the skew stays bypassed until every line
+    // in use has its memory again
+    for (int g = 0; g < groups; g++) {
+        if (!skewLines[0][g].acquire()) return;
+        if (right && !skewLines[1][g].acquire()) return;
+    }
     
-    // Micro-delay: 0-10ms with modulation
-    float delayMs = skew * 10.f;
-    int delaySamples = (int)(delayMs * 0.001f / sampleTime);
-    delaySamples = clamp(delaySamples, 0, SKEW_BUFFER_SIZE - 1);
+    // Write to the delay lines; right is null when running mono
+    for (int g = 0; g < groups; g++) {
+        skewLines[0][g].push(left[g]);
+        if (right) skewLines[1][g].push(right[g]);
+    }
     
-    int readIdx = (skewWriteIdx - delaySamples + SKEW_BUFFER_SIZE) % SKEW_BUFFER_SIZE;
+    // Micro-delay: 0-10ms, wobbled by up to the modulation depth at 1.3Hz
+    float modulation = mpdsp::sin2pi(skewMod.process(1.3f * sampleTime));
+    float delay = skew * (SKEW_MAX_DELAY - SKEW_MOD_DEPTH * modulation) / sampleTime;
     
-    // Add modulated micro-timing shift
-    float modulation = std::sin(2.f * M_PI * 1.3f * APP->engine->getFrame() * sampleTime);
-    int modulatedOffset = (int)(modulation * skew * 100.f);
-    readIdx = (readIdx + modulatedOffset + SKEW_BUFFER_SIZE) % SKEW_BUFFER_SIZE;
+    // One sample of minimum delay keeps the interpolator causal
+    delay = clamp(delay, 1.f, (float)(skewLines[0][0].size() - 3));
     
-    return skewBuffer[readIdx];
+    // All voices share the same read position
+    for (int g = 0; g < groups; g++) {
+        if (cubicSkew) {
+            left[g] = skewLines[0][g].readCubic(delay);
+            if (right) right[g] = skewLines[1][g].readCubic(delay);
+        }
+        else {
+            left[g] = skewLines[0][g].readLinear(delay);
+            if (right) right[g] = skewLines[1][g].readLinear(delay);
+        }
+    }
 }
 
-float OscillateurTritoniqueModule::processSpectralBloom(float bloom, float baseFreq, float sampleTime) {
-    // Generate harmonics with bloom-controlled expansion
-    float output = 0.f;
-    
+void OscillateurTritoniqueModule::updateUnison(float detune, bool stereo) {
+    if (unison == lastUnison && detune == lastDetune && stereo == lastStereo) return;
+    lastUnison = unison;
+    lastDetune = detune;
+    lastStereo = stereo;
+    
+    // Copies sit evenly between -detune and +detune cents around the voice
+    // pitch and are panned across the field in the same order. Uncorrelated
+    // copies add in power, hence the 1/sqrt(n) level
+    float level = 1.f / std::sqrt((float)unison);
+    for (int k = 0; k < MAX_UNISON; k++) {
+        float offset = (unison > 1) ? -1.f + 2.f * k / (float)(unison - 1) : 0.f;
+        bool active = k < unison;
+        unisonRatios[k / 4][k % 4] = std::pow(2.f, offset * detune * 50.f / 1200.f);
+        unisonGainsLeft[k / 4][k % 4] = active ? level * (stereo ? std::min(1.f - offset, 1.f) : 1.f) : 0.f;
+        unisonGainsRight[k / 4][k % 4] = active ? level * std::min(1.f + offset, 1.f) : 0.f;
+    }
+}
+
+void OscillateurTritoniqueModule::processUnison(int group, simd::float_4 baseFreq, float sampleTime, simd::float_4& left, simd::float_4& right) {
+    int lanes = std::min(channels - group * 4, 4);
+    int unisonGroups = (unison + 3) / 4;
+    for (int lane = 0; lane < lanes; lane++) {
+        simd::float_4* phases = unisonPhases[group * 4 + lane];
+        float baseDelta = baseFreq[lane] * sampleTime;
+        simd::float_4 sumLeft = 0.f;
+        simd::float_4 sumRight = 0.f;
+        for (int u = 0; u < unisonGroups; u++) {
+            phases[u] += unisonRatios[u] * baseDelta;
+            phases[u] -= simd::floor(phases[u]);
+            
+            simd::float_4 copies = processTopologyWarp(phases[u]);
+            sumLeft += copies * unisonGainsLeft[u];
+            sumRight += copies * unisonGainsRight[u];
+        }
+        left[lane] = sumLeft[0] + sumLeft[1] + sumLeft[2] + sumLeft[3];
+        right[lane] = sumRight[0] + sumRight[1] + sumRight[2] + sumRight[3];
+    }
+}
+
+void OscillateurTritoniqueModule::updateSpectralBloom(float bloom, int blockSize, bool jump) {
     for (int i = 0; i < NUM_HARMONICS; i++) {
         int harmonic = i + 1;
         
         // Amplitude decay with bloom extension
         float naturalDecay = 1.f / (float)harmonic;
         float bloomBoost = std::pow(1.f - bloom, (float)harmonic * 0.5f);
-        harmonicAmps[i] = naturalDecay * (0.3f + bloom * 0.7f) * bloomBoost;
+        harmonicAmps.target[i / 4][i % 4] = naturalDecay * (0.3f + bloom * 0.7f) * bloomBoost;
         
         // Frequency: base * harmonic with tritone inflection
-        float freq = baseFreq * harmonic;
+        float ratio = (float)harmonic;
         if (harmonic % 2 == 0 && bloom > 0.5f) {
             // Apply tritone shift to even harmonics at high bloom
-            freq *= 1.f + (bloom - 0.5f) * (TRITONE_RATIO - 1.f);
+            ratio *= 1.f + (bloom - 0.5f) * (TRITONE_RATIO - 1.f);
         }
-        
-        // Advance phase
-        harmonicPhases[i] += freq * sampleTime;
-        if (harmonicPhases[i] > 1.f) harmonicPhases[i] -= 1.f;
-        
-        // Generate sine
-        output += std::sin(2.f * M_PI * harmonicPhases[i]) * harmonicAmps[i];
+        harmonicRatios.target[i / 4][i % 4] = ratio;
+    }
+    harmonicAmps.start(blockSize, jump);
+    harmonicRatios.start(blockSize, jump);
+}
+
+simd::float_4 OscillateurTritoniqueModule::processSpectralBloom(int group, simd::float_4 baseFreq, float sampleTime) {
+    // Generate harmonics with bloom-controlled expansion; each voice runs its
+    // partials as float_4 groups
+    simd::float_4 output = 0.f;
+    int lanes = std::min(channels - group * 4, 4);
+    for (int lane = 0; lane < lanes; lane++) {
+        simd::float_4* phases = harmonicPhases[group * 4 + lane];
+        float baseDelta = baseFreq[lane] * sampleTime;
+        simd::float_4 sum = 0.f;
+        for (int g = 0; g < activeHarmonicGroups; g++) {
+            // Advance phases
+            phases[g] += harmonicRatios.value[g] * baseDelta;
+            phases[g] -= simd::floor(phases[g]);
+            
+            sum += mpdsp::sin2pi(phases[g]) * harmonicAmps.value[g];
+        }
+        output[lane] = sum[0] + sum[1] + sum[2] + sum[3];
     }
     
     return output;
 }
 
-float OscillateurTritoniqueModule::processTritoneGlide(float voct, float glide, float sampleTime) {
-    // Convert V/Oct to frequency
-    float inputFreq = 261.626f * std::pow(2.f, voct);
-    
-    // Apply tritone modulation with glide amount
-    float tritoneModulation = std::sin(2.f * M_PI * 0.7f * APP->engine->getFrame() * sampleTime);
-    float tritoneFreq = inputFreq * std::pow(TRITONE_RATIO, glide * tritoneModulation);
-    
-    targetFreq = tritoneFreq;
+simd::float_4 OscillateurTritoniqueModule::processTritoneGlide(int group, simd::float_4 voct, simd::float_4 glide, float modulation, float sampleTime) {
+    // V/Oct plus the tritone modulation in one exp2; the tritone is half an
+    // octave, so TRITONE_RATIO^x = 2^(x / 2)
+    simd::float_4 targetFreq = 261.626f * mpdsp::exp2(voct + 0.5f * glide * modulation);
     
     // Portamento with glide-controlled time constant
-    float portamentoTime = 0.001f + glide * 0.5f; // 1ms to 500ms
-    float lambda = sampleTime / portamentoTime;
-    lambda = clamp(lambda, 0.f, 1.f);
+    simd::float_4 portamentoTime = 0.001f + glide * 0.5f; // 1ms to 500ms
+    simd::float_4 lambda = simd::clamp(sampleTime / portamentoTime, 0.f, 1.f);
     
-    currentFreq += (targetFreq - currentFreq) * lambda;
+    currentFreqs[group] += (targetFreq - currentFreqs[group]) * lambda;
     
-    return currentFreq;
+    return currentFreqs[group];
 }
 
 void OscillateurTritoniqueModule::process(const ProcessArgs& args) {
     // Get parameters with CV
-    float topology = params[TOPOLOGY_PARAM].getValue();
-    if (inputs[TOPOLOGY_CV_INPUT].isConnected()) {
-        topology += inputs[TOPOLOGY_CV_INPUT].getVoltage() * params[TOPOLOGY_ATTEN_PARAM].getValue() * 0.1f;
+    bool blockStart = controlDivider.process();
+    if (blockStart && mpdsp::resolveQuality(quality) != appliedQuality) {
+        applyQuality(mpdsp::resolveQuality(quality));
     }
-    topology = clamp(topology, 0.f, 1.f);
-    
-    float skew = params[SKEW_PARAM].getValue();
-    if (inputs[SKEW_CV_INPUT].isConnected()) {
-        skew += inputs[SKEW_CV_INPUT].getVoltage() * params[SKEW_ATTEN_PARAM].getValue() * 0.1f;
+    int blockSize = (int)controlDivider.getDivision();
+    float topology = topologyParam.process(this, blockStart, blockSize);
+    float skew = skewParam.process(this, blockStart, blockSize);
+    // Bloom only feeds the ramped partials, which go by its block target
+    bloomParam.process(this, blockStart, blockSize);
+    
+    // One voice per V/Oct channel
+    channels = std::max(inputs[VOCT_INPUT].getChannels(), 1);
+    int groups = (channels + 3) / 4;
+    
+    // Right output carries the other half of the unison stereo spread
+    bool stereo = outputs[AUDIO_RIGHT_OUTPUT].isConnected();
+    
+    // Shared state: frame pair for the topology, partials for the bloom,
+    // detune and pan for the unison copies
+    if (topologyParam.changed()) {
+        topologyCursor = topologyBank->locate(topology * 2.f);
     }
-    skew = clamp(skew, 0.f, 1.f);
-    
-    float bloom = params[BLOOM_PARAM].getValue();
-    if (inputs[BLOOM_CV_INPUT].isConnected()) {
-        bloom += inputs[BLOOM_CV_INPUT].getVoltage() * params[BLOOM_ATTEN_PARAM].getValue() * 0.1f;
-    }
-    bloom = clamp(bloom, 0.f, 1.f);
-    
-    float glide = params[GLIDE_PARAM].getValue();
-    if (inputs[GLIDE_CV_INPUT].isConnected()) {
-        glide += inputs[GLIDE_CV_INPUT].getVoltage() * params[GLIDE_ATTEN_PARAM].getValue() * 0.1f;
+    if (bloomParam.targetChanged()) {
+        updateSpectralBloom(bloomParam.target(), blockSize, bloomParam.restartedBlock());
     }
-    glide = clamp(glide, 0.f, 1.f);
-    
-    // Get V/Oct input
-    float voct = 0.f;
-    if (inputs[VOCT_INPUT].isConnected()) {
-        voct = inputs[VOCT_INPUT].getVoltage();
+    harmonicAmps.process();
+    harmonicRatios.process();
+    updateUnison(params[UNISON_DETUNE_PARAM].getValue(), stereo);
+    
+    // Tritone modulation LFO, shared by all voices
+    float tritoneModulation = mpdsp::sin2pi(tritoneMod.process(0.7f * args.sampleTime));
+    
+    simd::float_4 mixed[MAX_VOICE_GROUPS];
+    simd::float_4 mixedRight[MAX_VOICE_GROUPS];
+    for (int g = 0; g < groups; g++) {
+        // Glide amount per voice
+        simd::float_4 glide = params[GLIDE_PARAM].getValue();
+        if (inputs[GLIDE_CV_INPUT].isConnected()) {
+            glide += inputs[GLIDE_CV_INPUT].getPolyVoltageSimd<simd::float_4>(g * 4) * params[GLIDE_ATTEN_PARAM].getValue() * 0.1f;
+        }
+        glide = simd::clamp(glide, 0.f, 1.f);
+        
+        // Get V/Oct input; lanes past the channel count are never output but
+        // still run, so keep them in a sane range
+        simd::float_4 voct = simd::clamp(inputs[VOCT_INPUT].getVoltageSimd<simd::float_4>(g * 4), -10.f, 10.f);
+        
+        // Process tritone glide to get current frequency
+        simd::float_4 freq = processTritoneGlide(g, voct, glide, tritoneModulation, args.sampleTime);
+        
+        // Get base oscillator output, one copy per voice or a unison stack
+        simd::float_4 baseOsc;
+        simd::float_4 baseOscRight;
+        if (unison == 1) {
+            // Advance wavetable phase
+            wavetablePhases[g] += freq * args.sampleTime;
+            wavetablePhases[g] -= simd::floor(wavetablePhases[g]);
+            baseOsc = processTopologyWarp(wavetablePhases[g]);
+            baseOscRight = baseOsc;
+        }
+        else {
+            processUnison(g, freq, args.sampleTime, baseOsc, baseOscRight);
+        }
+        
+        // Add spectral bloom harmonics
+        simd::float_4 bloomOutput = processSpectralBloom(g, freq, args.sampleTime);
+        
+        // Combine base + bloom
+        mixed[g] = baseOsc * 0.6f + bloomOutput * 0.4f;
+        mixedRight[g] = baseOscRight * 0.6f + bloomOutput * 0.4f;
     }
     
-    // Process tritone glide to get current frequency
-    float freq = processTritoneGlide(voct, glide, args.sampleTime);
-    
-    // Generate wavetable based on topology
-    generateWavetable(topology);
-    
-    // Advance wavetable phase
-    wavetablePhase += freq * args.sampleTime;
-    if (wavetablePhase >= 1.f) wavetablePhase -= 1.f;
-    
-    // Get base oscillator output
-    float baseOsc = processTopologyWarp(topology, wavetablePhase);
-    
-    // Add spectral bloom harmonics
-    float bloomOutput = processSpectralBloom(bloom, freq, args.sampleTime);
-    
-    // Combine base + bloom
-    float mixed = baseOsc * 0.6f + bloomOutput * 0.4f;
-    
     // Apply temporal skew
-    float output = processTemporalSkew(mixed, skew, args.sampleTime);
+    processTemporalSkew(mixed, stereo ? mixedRight : nullptr, groups, skew, args.sampleTime);
     
     // Output
-    outputs[AUDIO_OUTPUT].setVoltage(output * 5.f);
-}
+    outputs[AUDIO_OUTPUT].setChannels(channels);
+    for (int g = 0; g < groups; g++) {
+        outputs[AUDIO_OUTPUT].setVoltageSimd(mixed[g] * 5.f, g * 4);
+    }
+    if (stereo) {
+        outputs[AUDIO_RIGHT_OUTPUT].setChannels(channels);
+        for (int g = 0; g < groups; g++) {
+            outputs[AUDIO_RIGHT_OUTPUT].setVoltageSimd(mixedRight[g] * 5.f, g * 4);
+        }
+    }
+}
\ No newline at end of file
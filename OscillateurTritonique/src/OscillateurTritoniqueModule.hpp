@@ -1,5 +1,11 @@
 #pragma once
 #include <rack.hpp>
+#include "mpdsp/ControlParam.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/Phasor.hpp"
+#include "mpdsp/Quality.hpp"
+#include "mpdsp/FastMath.hpp"
+#include "mpdsp/WavetableBank.hpp"
 
 using namespace rack;
 
@@ -13,6 +19,7 @@ struct OscillateurTritoniqueModule : Module {
         BLOOM_ATTEN_PARAM,
         GLIDE_PARAM,
         GLIDE_ATTEN_PARAM,
+        UNISON_DETUNE_PARAM,
         NUM_PARAMS
     };
     enum InputIds {
@@ -25,30 +32,77 @@ struct OscillateurTritoniqueModule : Module {
     };
     enum OutputIds {
         AUDIO_OUTPUT,
+        AUDIO_RIGHT_OUTPUT,
         NUM_OUTPUTS
     };
     enum LightIds {
         NUM_LIGHTS
     };
 
-    // Wavetable morphing
+    // Polyphony: voices are processed four at a time
+    static constexpr int MAX_VOICES = 16;
+    static constexpr int MAX_VOICE_GROUPS = MAX_VOICES / 4;
+    int channels = 1;
+    
+    // Wavetable morphing between sine, saw and folded frames. The frames are
+    // one bank shared by every instance; the cursor holds this sample's pair
     static constexpr int WAVETABLE_SIZE = 2048;
-    float wavetable[WAVETABLE_SIZE];
-    float wavetablePhase = 0.f;
+    typedef mpdsp::WavetableBank<WAVETABLE_SIZE> TopologyBank;
+    const TopologyBank* topologyBank;
+    TopologyBank::Cursor topologyCursor;
+    simd::float_4 wavetablePhases[MAX_VOICE_GROUPS];
+    
+    // Per-voice portamento
+    simd::float_4 currentFreqs[MAX_VOICE_GROUPS];
+    
+    // Unison: up to 8 detuned copies of each voice's wavetable oscillator,
+    // run as float_4 lanes. Ratios and pan gains are shared by all voices and
+    // recomputed only when the copy count, detune or stereo routing changes
+    static constexpr int MAX_UNISON = 8;
+    static constexpr int MAX_UNISON_GROUPS = MAX_UNISON / 4;
+    int unison = 1;
+    int lastUnison = 0;
+    float lastDetune = -1.f;
+    bool lastStereo = false;
+    simd::float_4 unisonPhases[MAX_VOICES][MAX_UNISON_GROUPS];
+    simd::float_4 unisonRatios[MAX_UNISON_GROUPS];
+    simd::float_4 unisonGainsLeft[MAX_UNISON_GROUPS];
+    simd::float_4 unisonGainsRight[MAX_UNISON_GROUPS];
     
-    // Portamento
-    float targetFreq = 261.626f; // C4
-    float currentFreq = 261.626f;
+    // Micro delay for temporal skew, one lane per voice and a second set of
+    // lines for the right channel. Each line holds 10ms plus the modulation
+    // depth at the current sample rate, rounded up to a power of two
+    static constexpr float SKEW_MAX_DELAY = 0.010f;
+    static constexpr float SKEW_MOD_DEPTH = 0.00227f; // 100 samples at 44.1kHz
+    mpdsp::DelayLine<simd::float_4> skewLines[2][MAX_VOICE_GROUPS];
     
-    // Micro delay for temporal skew
-    static constexpr int SKEW_BUFFER_SIZE = 4096;
-    float skewBuffer[SKEW_BUFFER_SIZE] = {};
-    int skewWriteIdx = 0;
+    // Internal modulation LFOs (1.3Hz skew wobble, 0.7Hz tritone glide)
+    mpdsp::Phasor<float> skewMod;
+    mpdsp::Phasor<float> tritoneMod;
     
-    // Harmonic expansion for spectral bloom
+    // Harmonic expansion for spectral bloom, four partials per lane group.
+    // Amplitudes and frequency ratios only change with bloom and are shared
+    // by all voices. They are worked out once per control block and ramped
+    // across it
     static constexpr int NUM_HARMONICS = 12;
-    float harmonicPhases[NUM_HARMONICS] = {};
-    float harmonicAmps[NUM_HARMONICS] = {};
+    static constexpr int NUM_HARMONIC_GROUPS = NUM_HARMONICS / 4;
+    simd::float_4 harmonicPhases[MAX_VOICES][NUM_HARMONIC_GROUPS];
+    mpdsp::CoeffRamp<simd::float_4, NUM_HARMONIC_GROUPS> harmonicAmps;
+    mpdsp::CoeffRamp<simd::float_4, NUM_HARMONIC_GROUPS> harmonicRatios;
+    int activeHarmonicGroups = NUM_HARMONIC_GROUPS;
+    
+    // Knob and CV inputs, read at control rate. Topology and bloom only
+    // touch the shared state above when they move
+    mpdsp::ControlParam topologyParam;
+    mpdsp::ControlParam skewParam;
+    mpdsp::ControlParam bloomParam;
+    dsp::ClockDivider controlDivider;
+    
+    // Quality tier, saved with the patch; appliedQuality is the tier the
+    // harmonic count, skew interpolation and control rate were last set for
+    int quality = mpdsp::QUALITY_DEFAULT;
+    int appliedQuality = -1;
+    bool cubicSkew = true;
     
     // Tritone interval (sqrt(2), 600 cents)
     static constexpr float TRITONE_RATIO = 1.41421356237f;
@@ -56,11 +110,19 @@ struct OscillateurTritoniqueModule : Module {
     OscillateurTritoniqueModule();
     void process(const ProcessArgs& args) override;
     void onReset() override;
+    void onSampleRateChange(const SampleRateChangeEvent& e) override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void applyQuality(int tier);
     
     // DSP processors
-    void generateWavetable(float topology);
-    float processTopologyWarp(float topology, float phase);
-    float processTemporalSkew(float input, float skew, float sampleTime);
-    float processSpectralBloom(float bloom, float baseFreq, float sampleTime);
-    float processTritoneGlide(float voct, float glide, float sampleTime);
+    simd::float_4 processTopologyWarp(simd::float_4 phase);
+    static int skewLineSize(float sampleRate);
+    void configureSkew(float sampleRate);
+    void processTemporalSkew(simd::float_4* left, simd::float_4* right, int groups, float skew, float sampleTime);
+    void updateUnison(float detune, bool stereo);
+    void processUnison(int group, simd::float_4 baseFreq, float sampleTime, simd::float_4& left, simd::float_4& right);
+    void updateSpectralBloom(float bloom, int blockSize, bool jump);
+    simd::float_4 processSpectralBloom(int group, simd::float_4 baseFreq, float sampleTime);
+    simd::float_4 processTritoneGlide(int group, simd::float_4 voct, simd::float_4 glide, float modulation, float sampleTime);
 };
@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "OscillateurTritoniqueModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
     pluginInstance = p;
     p->addModel(modelOscillateurTritonique);
 }
+#endif
 
 struct OscillateurTritoniqueWidget : ModuleWidget {
     OscillateurTritoniqueWidget(OscillateurTritoniqueModule* module) {
@@ -62,6 +65,10 @@ struct OscillateurTritoniqueWidget : ModuleWidget {
         // V/Oct input and Audio output (bottom)
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(13.16f, 108.41f)), module, OscillateurTritoniqueModule::VOCT_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(26.32f, 108.41f)), module, OscillateurTritoniqueModule::AUDIO_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(36.5f, 108.41f)), module, OscillateurTritoniqueModule::AUDIO_RIGHT_OUTPUT));
+        
+        // Unison detune trimpot (bottom left)
+        addParam(createParamCentered<Trimpot>(mm2px(Vec(4.6f, 108.41f)), module, OscillateurTritoniqueModule::UNISON_DETUNE_PARAM));
 
         // Labels
         auto topoLabel = createWidget<ui::Label>(Vec(2, 106));
@@ -111,6 +118,45 @@ struct OscillateurTritoniqueWidget : ModuleWidget {
         outLabel->fontSize = 11;
         outLabel->color = nvgRGB(200, 200, 200);
         addChild(outLabel);
+
+        auto rightLabel = createWidget<ui::Label>(Vec(97.8f, 330));
+        rightLabel->box.size.x = 20;
+        rightLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+        rightLabel->text = "R";
+        rightLabel->fontSize = 11;
+        rightLabel->color = nvgRGB(200, 200, 200);
+        addChild(rightLabel);
+
+        auto detuneLabel = createWidget<ui::Label>(Vec(3.6f, 330));
+        detuneLabel->box.size.x = 20;
+        detuneLabel->alignment = ui::Label::CENTER_ALIGNMENT;
+        detuneLabel->text = "Det";
+        detuneLabel->fontSize = 10;
+        detuneLabel->color = nvgRGB(200, 200, 200);
+        addChild(detuneLabel);
+    }
+
+    // Picks up default quality changes made from other plugins
+    void step() override {
+        mpdsp::pollDefaultQuality();
+        ModuleWidget::step();
+    }
+
+    void appendContextMenu(Menu* menu) override {
+        OscillateurTritoniqueModule* module = dynamic_cast<OscillateurTritoniqueModule*>(this->module);
+        if (!module) return;
+
+        std::vector<std::string> unisonLabels = {"Off"};
+        for (int i = 2; i <= OscillateurTritoniqueModule::MAX_UNISON; i++) {
+            unisonLabels.push_back(string::f("%d voices", i));
+        }
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createIndexSubmenuItem("Unison", unisonLabels,
+            [=]() { return (size_t)(module->unison - 1); },
+            [=](size_t index) { module->unison = (int)index + 1; }
+        ));
+        mpdsp::appendQualityMenu(menu, &module->quality);
     }
 };
 
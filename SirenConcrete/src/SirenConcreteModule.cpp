@@ -3,6 +3,29 @@
 
 using namespace rack;
 
+namespace {
+
+// Dub siren waveform: sawtooth plus 2nd and 3rd harmonics
+struct SirenTable {
+	float samples[SirenConcreteModule::WAVETABLE_SIZE];
+	
+	SirenTable() {
+		for (int i = 0; i < SirenConcreteModule::WAVETABLE_SIZE; i++) {
+			float phase = (float)i / SirenConcreteModule::WAVETABLE_SIZE;
+			samples[i] = 2.0f * phase - 1.0f; // Sawtooth base
+			samples[i] += 0.3f * std::sin(2.0f * M_PI * phase * 2.0f); // 2nd harmonic
+			samples[i] += 0.2f * std::sin(2.0f * M_PI * phase * 3.0f); // 3rd harmonic
+		}
+	}
+};
+
+const float* getSirenTable() {
+	static const SirenTable table;
+	return table.samples;
+}
+
+} // namespace
+
 SirenConcreteModule::SirenConcreteModule() {
 	config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS);
 	
@@ -18,32 +41,48 @@ SirenConcreteModule::SirenConcreteModule() {
 	configParam(PHASE_DRIFT_ATTEN_PARAM, -1.0f, 1.0f, 0.0f, "Phase Drift CV", "%", 0.f, 100.f);
 	configParam(ECHO_BLOOM_ATTEN_PARAM, -1.0f, 1.0f, 0.0f, "Echo Bloom CV", "%", 0.f, 100.f);
 	
+	// Siren sweep (0.1 - 20 Hz, 0 - 2 octaves)
+	configParam(SWEEP_RATE_PARAM, 0.0f, 1.0f, 0.5f, "Sweep Rate", " Hz", 200.f, 0.1f);
+	configParam(SWEEP_DEPTH_PARAM, 0.0f, 1.0f, 0.0f, "Sweep Depth", " oct", 0.f, 2.f);
+	
 	// Inputs
 	configInput(PITCH_INPUT, "V/Oct");
 	configInput(GRAIN_MORPH_CV_INPUT, "Grain Morph CV");
 	configInput(SPECTRAL_SHIFT_CV_INPUT, "Spectral Shift CV");
 	configInput(PHASE_DRIFT_CV_INPUT, "Phase Drift CV");
 	configInput(ECHO_BLOOM_CV_INPUT, "Echo Bloom CV");
+	configInput(SWEEP_TRIGGER_INPUT, "Sweep Trigger");
 	
 	// Output
 	configOutput(AUDIO_OUTPUT, "Audio");
 	
-	// Initialize wavetable with dub siren waveform (sawtooth + overtones)
-	for (int i = 0; i < WAVETABLE_SIZE; i++) {
-		float phase = (float)i / WAVETABLE_SIZE;
-		wavetable[i] = 2.0f * phase - 1.0f; // Sawtooth base
-		wavetable[i] += 0.3f * std::sin(2.0f * M_PI * phase * 2.0f); // 2nd harmonic
-		wavetable[i] += 0.2f * std::sin(2.0f * M_PI * phase * 3.0f); // 3rd harmonic
-	}
+	// Shared siren waveform and lookup tables
+	grainMorphParam.config(GRAIN_MORPH_PARAM, GRAIN_MORPH_CV_INPUT, GRAIN_MORPH_ATTEN_PARAM);
+	spectralShiftParam.config(SPECTRAL_SHIFT_PARAM, SPECTRAL_SHIFT_CV_INPUT, SPECTRAL_SHIFT_ATTEN_PARAM);
+	phaseDriftParam.config(PHASE_DRIFT_PARAM, PHASE_DRIFT_CV_INPUT, PHASE_DRIFT_ATTEN_PARAM);
+	echoBloomParam.config(ECHO_BLOOM_PARAM, ECHO_BLOOM_CV_INPUT, ECHO_BLOOM_ATTEN_PARAM);
+	
+	wavetable = getSirenTable();
+	tables = mpdsp::sharedTables();
 	
 	// Initialize state
 	basePhase = 0.0f;
-	baseFreq = 220.0f;
+	baseFreq = 261.626f;
+	sweepShape = SWEEP_RISE;
+	sweepPhase = 0.0f;
+	sweepBlockCounter = 0;
+	sweepFreqRatio = 1.0f;
 	driftPhase = 0.0f;
 	driftAmount = 0.0f;
-	delayWritePos = 0;
-	activeGrains = MAX_GRAINS;
-	rng = 12345;
+	quality = mpdsp::QUALITY_DEFAULT;
+	applyQuality(mpdsp::resolveQuality(quality));
+	rng.setSeed(random::u64());
+	shiftMode = SHIFT_HARMONIC;
+	shifterCos = 1.0f;
+	shifterSin = 0.0f;
+	shifterFreq = -1.0f;
+	shifterStepCos = 1.0f;
+	shifterStepSin = 0.0f;
 	
 	for (int i = 0; i < MAX_GRAINS; i++) {
 		grainPhases[i] = (float)i / MAX_GRAINS;
@@ -52,61 +91,122 @@ SirenConcreteModule::SirenConcreteModule() {
 	}
 	
 	for (int i = 0; i < 16; i++) {
-		harmonicPhases[i] = 0.0f;
-		harmonicAmps[i] = 1.0f / (float)(i + 1);
+		harmonicPhases[i / 4][i % 4] = 0.0f;
+		harmonicAmps[i / 4][i % 4] = 1.0f / (float)(i + 1);
 	}
 	
-	for (int i = 0; i < DELAY_SIZE; i++) {
-		delayBuffer[i] = 0.0f;
-	}
+	configureEcho(48000.0f);
 }
 
-void SirenConcreteModule::process(const ProcessArgs& args) {
-	// Get CV-modulated parameters
-	float grainMorph = params[GRAIN_MORPH_PARAM].getValue();
-	if (inputs[GRAIN_MORPH_CV_INPUT].isConnected()) {
-		grainMorph += inputs[GRAIN_MORPH_CV_INPUT].getVoltage() * params[GRAIN_MORPH_ATTEN_PARAM].getValue() * 0.1f;
+void SirenConcreteModule::onSampleRateChange(const SampleRateChangeEvent& e) {
+	configureEcho(e.sampleRate);
+}
+
+json_t* SirenConcreteModule::dataToJson() {
+	json_t* rootJ = json_object();
+	json_object_set_new(rootJ, "shiftMode", json_integer(shiftMode));
+	json_object_set_new(rootJ, "sweepShape", json_integer(sweepShape));
+	mpdsp::seedToJson(rootJ, rng, id);
+	json_object_set_new(rootJ, "quality", json_integer(quality));
+	return rootJ;
+}
+
+void SirenConcreteModule::dataFromJson(json_t* rootJ) {
+	json_t* shiftModeJ = json_object_get(rootJ, "shiftMode");
+	if (shiftModeJ) {
+		shiftMode = clamp((int)json_integer_value(shiftModeJ), 0, NUM_SHIFT_MODES - 1);
 	}
-	grainMorph = clamp(grainMorph, 0.0f, 1.0f);
 	
-	float spectralShift = params[SPECTRAL_SHIFT_PARAM].getValue();
-	if (inputs[SPECTRAL_SHIFT_CV_INPUT].isConnected()) {
-		spectralShift += inputs[SPECTRAL_SHIFT_CV_INPUT].getVoltage() * params[SPECTRAL_SHIFT_ATTEN_PARAM].getValue() * 0.1f;
+	json_t* sweepShapeJ = json_object_get(rootJ, "sweepShape");
+	if (sweepShapeJ) {
+		sweepShape = clamp((int)json_integer_value(sweepShapeJ), 0, NUM_SWEEP_SHAPES - 1);
 	}
-	spectralShift = clamp(spectralShift, 0.0f, 1.0f);
 	
-	float phaseDrift = params[PHASE_DRIFT_PARAM].getValue();
-	if (inputs[PHASE_DRIFT_CV_INPUT].isConnected()) {
-		phaseDrift += inputs[PHASE_DRIFT_CV_INPUT].getVoltage() * params[PHASE_DRIFT_ATTEN_PARAM].getValue() * 0.1f;
+	uint64_t seed;
+	if (mpdsp::seedFromJson(rootJ, id, &seed)) {
+		rng.setSeed(seed);
 	}
-	phaseDrift = clamp(phaseDrift, 0.0f, 1.0f);
 	
-	float echoBloom = params[ECHO_BLOOM_PARAM].getValue();
-	if (inputs[ECHO_BLOOM_CV_INPUT].isConnected()) {
-		echoBloom += inputs[ECHO_BLOOM_CV_INPUT].getVoltage() * params[ECHO_BLOOM_ATTEN_PARAM].getValue() * 0.1f;
+	json_t* qualityJ = json_object_get(rootJ, "quality");
+	if (qualityJ) {
+		quality = clamp((int)json_integer_value(qualityJ), mpdsp::QUALITY_DEFAULT, mpdsp::NUM_QUALITIES - 1);
+	}
+}
+
+void SirenConcreteModule::applyQuality(int tier) {
+	// Eco runs half the grains and half the shift harmonics; High
+	// interpolates the wavetable reads instead of taking the nearest sample
+	static const int GRAIN_COUNTS[mpdsp::NUM_QUALITIES] = {MAX_GRAINS / 2, MAX_GRAINS, MAX_GRAINS};
+	static const int HARMONIC_GROUP_COUNTS[mpdsp::NUM_QUALITIES] = {2, 4, 4};
+	appliedQuality = tier;
+	activeGrains = GRAIN_COUNTS[tier];
+	activeHarmonicGroups = HARMONIC_GROUP_COUNTS[tier];
+	interpolateWavetable = (tier == mpdsp::QUALITY_HIGH);
+}
+
+float SirenConcreteModule::readWavetable(float phase) {
+	float pos = phase * WAVETABLE_SIZE;
+	int idx = (int)pos;
+	if (!interpolateWavetable) return wavetable[idx % WAVETABLE_SIZE];
+	float a = wavetable[idx % WAVETABLE_SIZE];
+	float b = wavetable[(idx + 1) % WAVETABLE_SIZE];
+	return a + (b - a) * (pos - (float)idx);
+}
+
+void SirenConcreteModule::process(const ProcessArgs& args) {
+	// Nothing to hear: the sweep, grains and echoes pick up where they
+	// stopped once the output is patched again
+	if (!outputs[AUDIO_OUTPUT].isConnected()) return;
+	
+	// Trigger restarts the sweep cycle immediately rather than at the next block
+	if (sweepTrigger.process(inputs[SWEEP_TRIGGER_INPUT].getVoltage(), 0.1f, 1.0f)) {
+		sweepPhase = 0.0f;
+		sweepBlockCounter = 0;
 	}
-	echoBloom = clamp(echoBloom, 0.0f, 1.0f);
 	
-	// Get pitch from V/Oct input
-	float pitch = 0.0f;
-	if (inputs[PITCH_INPUT].isConnected()) {
-		pitch = inputs[PITCH_INPUT].getVoltage();
+	// Get CV-modulated parameters, knobs once per sweep block
+	bool blockStart = (sweepBlockCounter == 0);
+	if (blockStart && mpdsp::resolveQuality(quality) != appliedQuality) {
+		applyQuality(mpdsp::resolveQuality(quality));
 	}
-	baseFreq = 261.626f * std::pow(2.0f, pitch); // C4 = 261.626 Hz
+	float grainMorph = grainMorphParam.process(this, blockStart);
+	float spectralShift = spectralShiftParam.process(this, blockStart);
+	float phaseDrift = phaseDriftParam.process(this, blockStart);
+	float echoBloom = echoBloomParam.process(this, blockStart);
+	
+	// Pitch (V/Oct + sweep) is resolved once per block, then ramped exponentially per sample
+	if (sweepBlockCounter == 0) {
+		float pitch = 0.0f;
+		if (inputs[PITCH_INPUT].isConnected()) {
+			pitch = inputs[PITCH_INPUT].getVoltage();
+		}
+		
+		float rate = 0.1f * std::pow(200.0f, params[SWEEP_RATE_PARAM].getValue());
+		float depth = params[SWEEP_DEPTH_PARAM].getValue() * 2.0f;
+		pitch += processSweep(rate, args.sampleTime) * depth;
+		
+		float targetFreq = 261.626f * mpdsp::exp2(pitch); // C4 = 261.626 Hz
+		// Ramp from wherever the pitch is now, so a trigger mid-block
+		// does not step it
+		sweepFreqRatio = std::pow(targetFreq / baseFreq, 1.0f / SWEEP_BLOCK_SIZE);
+	}
+	sweepBlockCounter = (sweepBlockCounter + 1) % SWEEP_BLOCK_SIZE;
+	baseFreq *= sweepFreqRatio;
 	
 	// Base oscillator
 	float deltaPhase = baseFreq / args.sampleRate;
 	basePhase += deltaPhase;
 	if (basePhase >= 1.0f) basePhase -= 1.0f;
 	
-	int tableIndex = (int)(basePhase * WAVETABLE_SIZE) % WAVETABLE_SIZE;
-	float output = wavetable[tableIndex];
+	float output = readWavetable(basePhase);
 	
 	// Stage 1: Grain Morph
 	output = processGrainMorph(output, grainMorph, args.sampleRate);
 	
-	// Stage 2: Spectral Shift
-	output = processSpectralShift(output, spectralShift, baseFreq);
+	// Stage 2: Spectral Shift (harmonic mode)
+	if (shiftMode == SHIFT_HARMONIC) {
+		output = processSpectralShift(output, spectralShift, baseFreq);
+	}
 	
 	// Stage 3: Phase Drift
 	output = processPhaseDrift(output, phaseDrift, args.sampleRate);
@@ -114,6 +214,11 @@ void SirenConcreteModule::process(const ProcessArgs& args) {
 	// Stage 4: Echo Bloom
 	output = processEchoBloom(output, echoBloom, args.sampleRate);
 	
+	// Stage 5: Spectral Shift (frequency shifter mode, acts on the grain/echo output)
+	if (shiftMode == SHIFT_FREQUENCY) {
+		output = processFrequencyShift(output, spectralShift, args.sampleRate);
+	}
+	
 	outputs[AUDIO_OUTPUT].setVoltage(clamp(output * 5.0f, -10.0f, 10.0f));
 }
 
@@ -121,29 +226,55 @@ void SirenConcreteModule::process(const ProcessArgs& args) {
 // DSP HELPER FUNCTIONS
 // ================================================================
 
+float SirenConcreteModule::processSweep(float rate, float sampleTime) {
+	// Advance by a whole block; returns the sweep position in 0..1
+	sweepPhase += rate * sampleTime * SWEEP_BLOCK_SIZE;
+	if (sweepPhase >= 1.0f) sweepPhase -= std::floor(sweepPhase);
+	
+	switch (sweepShape) {
+		case SWEEP_RISE:
+			// Capacitor-charge curve of a classic siren rise
+			return (1.0f - std::exp(-4.0f * sweepPhase)) / (1.0f - std::exp(-4.0f));
+		case SWEEP_FALL:
+			return 1.0f - (1.0f - std::exp(-4.0f * sweepPhase)) / (1.0f - std::exp(-4.0f));
+		case SWEEP_WARBLE:
+			return tables->hann(sweepPhase);
+		case SWEEP_TRILL:
+			// Two-note alternation, softened by the per-sample pitch ramp
+			return (sweepPhase < 0.5f) ? 0.0f : 1.0f;
+		default:
+			return 0.0f;
+	}
+}
+
 float SirenConcreteModule::processGrainMorph(float input, float morph, float sampleRate) {
 	if (morph < 0.01f) return input;
 	
 	// Granular resynthesis: scatter playback across grains
 	float output = input * (1.0f - morph);
 	
+	// Rate jitter for four grains per draw
+	simd::float_4 jitter = 0.0f;
 	for (int i = 0; i < activeGrains; i++) {
+		if ((i & 3) == 0) {
+			jitter = (rng.uniform4() - 0.5f) * (morph * 0.3f);
+		}
+		
 		// Update grain phases with jittered rates
-		float rateVariation = 1.0f + (random() - 0.5f) * morph * 0.3f;
+		float rateVariation = 1.0f + jitter[i & 3];
 		grainPhases[i] += baseFreq / sampleRate * rateVariation;
 		if (grainPhases[i] >= 1.0f) {
 			grainPhases[i] -= 1.0f;
 			// Regenerate grain on wrap
-			grainAmps[i] = 0.5f + random() * 0.5f;
+			grainAmps[i] = 0.5f + rng.uniform() * 0.5f;
 			grainRates[i] = rateVariation;
 		}
 		
 		// Grain envelope (Hann window)
-		float envelope = 0.5f * (1.0f - std::cos(2.0f * M_PI * grainPhases[i]));
+		float envelope = tables->hann(grainPhases[i]);
 		
 		// Sample from wavetable
-		int idx = (int)(grainPhases[i] * WAVETABLE_SIZE) % WAVETABLE_SIZE;
-		float grainSample = wavetable[idx] * envelope * grainAmps[i];
+		float grainSample = readWavetable(grainPhases[i]) * envelope * grainAmps[i];
 		
 		output += grainSample * morph / (float)activeGrains;
 	}
@@ -157,20 +288,19 @@ float SirenConcreteModule::processSpectralShift(float input, float shift, float
 	// Spectral shifting: modulate harmonics with shifted frequencies
 	float output = input * (1.0f - shift * 0.7f);
 	
-	for (int i = 0; i < 16; i++) {
+	rack::simd::float_4 sum = 0.0f;
+	for (int g = 0; g < activeHarmonicGroups; g++) {
 		// Shift harmonic frequencies by shift amount
-		float shiftedHarmonic = (float)(i + 1) * (1.0f + shift * 2.0f);
-		harmonicPhases[i] += shiftedHarmonic * freq / 48000.0f;
-		if (harmonicPhases[i] >= 1.0f) harmonicPhases[i] -= 1.0f;
+		rack::simd::float_4 number(4 * g + 1, 4 * g + 2, 4 * g + 3, 4 * g + 4);
+		rack::simd::float_4 shiftedHarmonic = number * (1.0f + shift * 2.0f);
+		harmonicPhases[g] += shiftedHarmonic * freq / 48000.0f;
+		harmonicPhases[g] -= rack::simd::floor(harmonicPhases[g]);
 		
 		// Generate harmonic
-		float harmonic = std::sin(2.0f * M_PI * harmonicPhases[i]);
-		harmonic *= harmonicAmps[i] * shift * 0.5f;
-		
-		output += harmonic;
+		sum += mpdsp::sin2pi(harmonicPhases[g]) * harmonicAmps[g];
 	}
 	
-	return output;
+	return output + (sum[0] + sum[1] + sum[2] + sum[3]) * shift * 0.5f;
 }
 
 float SirenConcreteModule::processPhaseDrift(float input, float drift, float sampleRate) {
@@ -182,8 +312,8 @@ float SirenConcreteModule::processPhaseDrift(float input, float drift, float sam
 	if (driftPhase >= 1.0f) driftPhase -= 1.0f;
 	
 	// Create drift modulation
-	float lfo = std::sin(2.0f * M_PI * driftPhase);
-	lfo += 0.3f * std::sin(2.0f * M_PI * driftPhase * 2.3f); // Add inharmonic component
+	float lfo = tables->sin2pi(driftPhase);
+	lfo += 0.3f * tables->sin2pi(driftPhase * 2.3f); // Add inharmonic component
 	
 	driftAmount = lfo * drift * 0.05f;
 	
@@ -192,42 +322,109 @@ float SirenConcreteModule::processPhaseDrift(float input, float drift, float sam
 	if (driftedPhase >= 1.0f) driftedPhase -= 1.0f;
 	if (driftedPhase < 0.0f) driftedPhase += 1.0f;
 	
-	int idx = (int)(driftedPhase * WAVETABLE_SIZE) % WAVETABLE_SIZE;
-	float driftedSample = wavetable[idx];
+	float driftedSample = readWavetable(driftedPhase);
 	
 	return input * (1.0f - drift * 0.5f) + driftedSample * drift * 0.5f;
 }
 
-float SirenConcreteModule::processEchoBloom(float input, float bloom, float sampleRate) {
-	if (bloom < 0.01f) return input;
-	
-	// Write to delay buffer
-	delayBuffer[delayWritePos] = input;
-	delayWritePos = (delayWritePos + 1) % DELAY_SIZE;
+void SirenConcreteModule::configureEcho(float sampleRate) {
+	// Only the size is recorded, as this also runs on the engine thread; the
+	// buffer itself is taken once bloom is turned up
+	echoLine.requestSize((int)(ECHO_MAX_DELAY * sampleRate) + 4);
+	echoBlockCounter = 0;
+	
+	// 2.5 kHz one-pole damping in the feedback path
+	echoDamping = 1.0f - std::exp(-2.0f * M_PI * 2500.0f / sampleRate);
+	echoFeedback = 0.0f;
+	echoFeedbackState = 0.0f;
+	
+	// Start from the zero-bloom tap layout so the first block ramps smoothly
+	for (int g = 0; g < ECHO_TAPS / 4; g++) {
+		simd::float_4 tapIndex = simd::float_4(0.0f, 1.0f, 2.0f, 3.0f) + (float)(g * 4);
+		tapDelays[g] = 0.05f * sampleRate * (1.0f + tapIndex * 0.15f);
+		tapDelaySteps[g] = 0.0f;
+		tapGains[g] = 0.0f;
+	}
+}
+
+void SirenConcreteModule::updateEchoTaps(float bloom, float sampleRate) {
+	// Tap layout only changes with bloom, so it is resolved once per block
+	// and the delays are ramped linearly towards it sample by sample
+	float delayTime = (0.05f + bloom * 0.2f) * sampleRate; // 50-250ms base
+	float maxDelay = (float)(echoLine.size() - 2);
+	
+	// Darken even taps, brighten odd taps
+	simd::float_4 coloration(1.0f - 0.3f * bloom, 1.0f + 0.2f * bloom, 1.0f - 0.3f * bloom, 1.0f + 0.2f * bloom);
+	
+	for (int g = 0; g < ECHO_TAPS / 4; g++) {
+		simd::float_4 tapIndex = simd::float_4(0.0f, 1.0f, 2.0f, 3.0f) + (float)(g * 4);
+		simd::float_4 target = simd::clamp(delayTime * (1.0f + tapIndex * 0.15f), 1.0f, maxDelay);
+		tapDelaySteps[g] = (target - tapDelays[g]) / (float)ECHO_BLOCK_SIZE;
+		tapGains[g] = bloom * 0.6f / (tapIndex + 1.0f) * coloration;
+	}
 	
-	// Read multiple taps with spectral spreading
-	float output = input;
-	int numTaps = 8;
-	float delayTime = 0.05f + bloom * 0.2f; // 50-250ms base
+	echoFeedback = bloom * 0.8f;
+}
+
+float SirenConcreteModule::processEchoBloom(float input, float bloom, float sampleRate) {
+	if (bloom < 0.01f || !echoLine.acquire()) return input;
 	
-	for (int i = 0; i < numTaps; i++) {
-		float tapDelay = delayTime * (1.0f + (float)i * 0.15f);
-		int tapSamples = (int)(tapDelay * sampleRate);
-		int readPos = (delayWritePos - tapSamples + DELAY_SIZE) % DELAY_SIZE;
-		
-		float tapSample = delayBuffer[readPos];
-		float tapAmp = bloom * 0.6f / (float)(i + 1);
+	if (echoBlockCounter == 0) {
+		updateEchoTaps(bloom, sampleRate);
+	}
+	echoBlockCounter = (echoBlockCounter + 1) % ECHO_BLOCK_SIZE;
+	
+	// Write input plus the damped regeneration from the longest tap
+	echoLine.push(input + echoFeedbackState * echoFeedback);
+	
+	// Gather the eight fractional taps as two float_4 groups with linear interpolation
+	simd::float_4 tapSum = 0.0f;
+	float longestTap = 0.0f;
+	for (int g = 0; g < ECHO_TAPS / 4; g++) {
+		tapDelays[g] += tapDelaySteps[g];
+		simd::float_4 delayFloor = simd::floor(tapDelays[g]);
+		simd::float_4 frac = tapDelays[g] - delayFloor;
 		
-		// Apply spectral coloration per tap
-		float coloredSample = tapSample;
-		if (i % 2 == 0) {
-			coloredSample *= 1.0f - 0.3f * bloom; // Darken even taps
-		} else {
-			coloredSample *= 1.0f + 0.2f * bloom; // Brighten odd taps
+		simd::float_4 tapA, tapB;
+		for (int k = 0; k < 4; k++) {
+			int d = (int)delayFloor[k];
+			tapA.s[k] = echoLine.read(d);
+			tapB.s[k] = echoLine.read(d + 1);
 		}
+		simd::float_4 taps = tapA + (tapB - tapA) * frac;
 		
-		output += coloredSample * tapAmp;
+		tapSum += taps * tapGains[g];
+		longestTap = taps[3];
 	}
+	echoFeedbackState = mpdsp::flushDenormal(echoFeedbackState + echoDamping * (longestTap - echoFeedbackState));
 	
+	float output = input + tapSum[0] + tapSum[1] + tapSum[2] + tapSum[3];
 	return output * 0.6f; // Normalize to prevent clipping
 }
+
+float SirenConcreteModule::processFrequencyShift(float input, float shift, float sampleRate) {
+	if (shift < 0.01f) return input;
+	
+	// Single-sideband shift up to 1 kHz, squared for finer control of small inharmonic offsets
+	float freq = shift * shift * 1000.0f / sampleRate;
+	if (freq != shifterFreq) {
+		shifterFreq = freq;
+		shifterStepCos = std::cos(2.0f * M_PI * freq);
+		shifterStepSin = std::sin(2.0f * M_PI * freq);
+	}
+	
+	float quadrature;
+	float inPhase = hilbert.process(input, quadrature);
+	
+	// Upper sideband: Re{(I + jQ) * e^(j*theta)}
+	float output = inPhase * shifterCos - quadrature * shifterSin;
+	
+	// Rotate the oscillator phasor and renormalize to keep its amplitude at 1
+	float c = shifterCos * shifterStepCos - shifterSin * shifterStepSin;
+	float s = shifterCos * shifterStepSin + shifterSin * shifterStepCos;
+	float gain = 1.5f - 0.5f * (c * c + s * s);
+	shifterCos = c * gain;
+	shifterSin = s * gain;
+	
+	return output;
+}
@@ -1,5 +1,61 @@
 #pragma once
 #include "rack.hpp"
+#include "mpdsp/ControlParam.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/Denormal.hpp"
+#include "mpdsp/FastMath.hpp"
+#include "mpdsp/Quality.hpp"
+#include "mpdsp/RandomStream.hpp"
+#include "mpdsp/Tables.hpp"
+
+// Polyphase IIR Hilbert pair (Niemitalo coefficients). Each path is a chain of
+// four second-order all-pass sections in z^-2. The sections of one chain are
+// pipelined across the lanes of a float_4, so a whole chain advances with a
+// single vector update per sample; both chains share the resulting 3-sample
+// latency, which keeps them in quadrature.
+struct HilbertTransformer {
+	rack::simd::float_4 coeffsA;
+	rack::simd::float_4 coeffsB;
+	rack::simd::float_4 inA1, inA2, outA1, outA2;
+	rack::simd::float_4 inB1, inB2, outB1, outB2;
+	float delayA;
+
+	HilbertTransformer() {
+		// Squared all-pass coefficients
+		coeffsA = rack::simd::float_4(0.6923878f, 0.9360654322959f, 0.9882295226860f, 0.9987488452737f);
+		coeffsB = rack::simd::float_4(0.4021921162426f, 0.8561710882420f, 0.9722909545651f, 0.9952884791278f);
+		coeffsA *= coeffsA;
+		coeffsB *= coeffsB;
+		reset();
+	}
+
+	void reset() {
+		inA1 = inA2 = outA1 = outA2 = 0.f;
+		inB1 = inB2 = outB1 = outB2 = 0.f;
+		delayA = 0.f;
+	}
+
+	static float chain(float input, rack::simd::float_4 coeffs, rack::simd::float_4& in1, rack::simd::float_4& in2,
+		rack::simd::float_4& out1, rack::simd::float_4& out2) {
+		// Lane k is fed by the previous sample's output of lane k-1
+		rack::simd::float_4 in(input, out1[0], out1[1], out1[2]);
+		rack::simd::float_4 out = coeffs * (in + out2) - in2;
+		in2 = in1;
+		in1 = in;
+		out2 = out1;
+		out1 = mpdsp::flushDenormal(out);
+		return out[3];
+	}
+
+	// Returns the in-phase part; quadrature receives the 90-degree lagging part
+	float process(float input, float& quadrature) {
+		float a = chain(input, coeffsA, inA1, inA2, outA1, outA2);
+		float b = chain(input, coeffsB, inB1, inB2, outB1, outB2);
+		quadrature = delayA;
+		delayA = a;
+		return b;
+	}
+};
 
 struct SirenConcreteModule : rack::Module {
 	enum ParamIds {
@@ -11,6 +67,8 @@ struct SirenConcreteModule : rack::Module {
 		SPECTRAL_SHIFT_ATTEN_PARAM,
 		PHASE_DRIFT_ATTEN_PARAM,
 		ECHO_BLOOM_ATTEN_PARAM,
+		SWEEP_RATE_PARAM,
+		SWEEP_DEPTH_PARAM,
 		NUM_PARAMS
 	};
 	enum InputIds {
@@ -19,60 +77,116 @@ struct SirenConcreteModule : rack::Module {
 		SPECTRAL_SHIFT_CV_INPUT,
 		PHASE_DRIFT_CV_INPUT,
 		ECHO_BLOOM_CV_INPUT,
+		SWEEP_TRIGGER_INPUT,
 		NUM_INPUTS
 	};
 	enum OutputIds {
 		AUDIO_OUTPUT,
 		NUM_OUTPUTS
 	};
+	enum ShiftMode {
+		SHIFT_HARMONIC,
+		SHIFT_FREQUENCY,
+		NUM_SHIFT_MODES
+	};
+	enum SweepShape {
+		SWEEP_RISE,
+		SWEEP_FALL,
+		SWEEP_WARBLE,
+		SWEEP_TRILL,
+		NUM_SWEEP_SHAPES
+	};
 
 	// Granular synthesis state
 	static constexpr int WAVETABLE_SIZE = 2048;
 	static constexpr int MAX_GRAINS = 8;
-	static constexpr int DELAY_SIZE = 8192;
+	static constexpr int ECHO_TAPS = 8;
+	static constexpr int ECHO_BLOCK_SIZE = 32;
+	static constexpr float ECHO_MAX_DELAY = 0.55f; // Seconds, longest tap at full bloom is ~513ms
 	
-	float wavetable[WAVETABLE_SIZE];
+	const float* wavetable; // Shared by every instance
+	const mpdsp::Tables* tables;
 	float grainPhases[MAX_GRAINS];
 	float grainAmps[MAX_GRAINS];
 	float grainRates[MAX_GRAINS];
 	int activeGrains;
 	
-	// Spectral shift state
-	float harmonicPhases[16];
-	float harmonicAmps[16];
+	// Spectral shift state, 16 harmonics in four SIMD groups
+	rack::simd::float_4 harmonicPhases[4];
+	rack::simd::float_4 harmonicAmps[4];
+	int activeHarmonicGroups;
+	int shiftMode;
+	
+	// Single-sideband frequency shifter (quadrature oscillator as a rotating phasor)
+	HilbertTransformer hilbert;
+	float shifterCos;
+	float shifterSin;
+	float shifterFreq;
+	float shifterStepCos;
+	float shifterStepSin;
 	
 	// Phase drift LFO
 	float driftPhase;
 	float driftAmount;
 	
-	// Echo bloom delay
-	float delayBuffer[DELAY_SIZE];
-	int delayWritePos;
+	// Echo bloom delay, sized from the sample rate; its memory is only taken
+	// once bloom is turned up
+	mpdsp::DelayLine<float> echoLine;
+	int echoBlockCounter;
+	
+	// Fractional tap delays in samples, ramped across each block, as two float_4 groups of 4 taps
+	rack::simd::float_4 tapDelays[ECHO_TAPS / 4];
+	rack::simd::float_4 tapDelaySteps[ECHO_TAPS / 4];
+	rack::simd::float_4 tapGains[ECHO_TAPS / 4];
+	
+	// Damped feedback from the longest tap
+	float echoFeedback;
+	float echoDamping;
+	float echoFeedbackState;
 	
 	// Base oscillator
 	float basePhase;
 	float baseFreq;
 	
-	// RNG
-	uint32_t rng;
+	// Dub siren sweep, evaluated once per block; baseFreq follows it
+	// with a per-sample geometric ramp (linear in pitch)
+	static constexpr int SWEEP_BLOCK_SIZE = 32;
+	int sweepShape;
+	float sweepPhase;
+	int sweepBlockCounter;
+	float sweepFreqRatio;
+	rack::dsp::SchmittTrigger sweepTrigger;
+	
+	// Knob and CV inputs; the knobs are read on the sweep block boundaries
+	mpdsp::ControlParam grainMorphParam;
+	mpdsp::ControlParam spectralShiftParam;
+	mpdsp::ControlParam phaseDriftParam;
+	mpdsp::ControlParam echoBloomParam;
+	
+	// Quality tier, saved with the patch; appliedQuality is the tier the
+	// grain and harmonic counts were last set for
+	int quality;
+	int appliedQuality;
+	bool interpolateWavetable;
+	
+	// Per-instance random stream, seeded once and saved with the patch
+	mpdsp::RandomStream rng;
 
 	SirenConcreteModule();
 	void process(const ProcessArgs& args) override;
+	void onSampleRateChange(const SampleRateChangeEvent& e) override;
+	json_t* dataToJson() override;
+	void dataFromJson(json_t* rootJ) override;
+	void applyQuality(int tier);
+	float readWavetable(float phase);
 	
 	// DSP helper functions
 	float processGrainMorph(float input, float morph, float sampleRate);
 	float processSpectralShift(float input, float shift, float freq);
 	float processPhaseDrift(float input, float drift, float sampleRate);
 	float processEchoBloom(float input, float bloom, float sampleRate);
-	
-	uint32_t xorshift32() {
-		rng ^= rng << 13;
-		rng ^= rng >> 17;
-		rng ^= rng << 5;
-		return rng;
-	}
-	
-	float random() {
-		return (float)xorshift32() / (float)0xFFFFFFFF;
-	}
+	float processSweep(float rate, float sampleTime);
+	float processFrequencyShift(float input, float shift, float sampleRate);
+	void configureEcho(float sampleRate);
+	void updateEchoTaps(float bloom, float sampleRate);
 };
@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "SirenConcreteModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
 	pluginInstance = p;
 	p->addModel(modelSirenConcrete);
 }
+#endif
 
 struct SirenConcreteWidget : ModuleWidget {
 	SirenConcreteWidget(SirenConcreteModule* module) {
@@ -50,6 +53,11 @@ struct SirenConcreteWidget : ModuleWidget {
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(24.0f, 95.0f)), module, SirenConcreteModule::PHASE_DRIFT_CV_INPUT));
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(32.5f, 95.0f)), module, SirenConcreteModule::ECHO_BLOOM_CV_INPUT));
 		
+		// Siren sweep: rate, trigger, depth (between main knobs and attenuverters)
+		addParam(createParamCentered<Trimpot>(mm2px(Vec(7.0f, 66.5f)), module, SirenConcreteModule::SWEEP_RATE_PARAM));
+		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(19.74f, 66.5f)), module, SirenConcreteModule::SWEEP_TRIGGER_INPUT));
+		addParam(createParamCentered<Trimpot>(mm2px(Vec(32.5f, 66.5f)), module, SirenConcreteModule::SWEEP_DEPTH_PARAM));
+		
 		// Trigger input and audio output (bottom)
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(13.16f, 108.41f)), module, SirenConcreteModule::PITCH_INPUT));
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(26.32f, 108.41f)), module, SirenConcreteModule::AUDIO_OUTPUT));
@@ -103,6 +111,21 @@ struct SirenConcreteWidget : ModuleWidget {
 		outLabel->color = nvgRGB(200, 200, 200);
 		addChild(outLabel);
 	}
+
+	// Picks up default quality changes made from other plugins
+	void step() override {
+		mpdsp::pollDefaultQuality();
+		ModuleWidget::step();
+	}
+
+	void appendContextMenu(Menu* menu) override {
+		SirenConcreteModule* module = getModule<SirenConcreteModule>();
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createIndexPtrSubmenuItem("Spectral shift mode", {"Harmonic", "Frequency shifter"}, &module->shiftMode));
+		menu->addChild(createIndexPtrSubmenuItem("Sweep shape", {"Rise", "Fall", "Warble", "Trill"}, &module->sweepShape));
+		mpdsp::appendQualityMenu(menu, &module->quality);
+	}
 };
 
 Model* modelSirenConcrete = createModel<SirenConcreteModule, SirenConcreteWidget>("SirenConcrete");
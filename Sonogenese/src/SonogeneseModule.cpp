@@ -1,6 +1,64 @@
 #include "SonogeneseModule.hpp"
 #include <cmath>
 
+namespace {
+
+void generateWavetable(float topology, float* frame) {
+	// Generate morphing wavetable based on topology parameter
+	// sine → Chebyshev → folded → impulses
+	
+	for (int i = 0; i < SonogeneseModule::WAVETABLE_SIZE; i++) {
+		float t = (float)i / SonogeneseModule::WAVETABLE_SIZE;
+		float sample = 0.0f;
+		
+		if (topology < 0.33f) {
+			// Sine to Chebyshev blend (0.0 - 0.33)
+			float blend = topology / 0.33f;
+			float sine = std::sin(2.0f * M_PI * t);
+			float cheby = mpdsp::chebyshev(5, std::sin(2.0f * M_PI * t));
+			sample = sine * (1.0f - blend) + cheby * blend;
+		}
+		else if (topology < 0.66f) {
+			// Chebyshev to folded (0.33 - 0.66)
+			float blend = (topology - 0.33f) / 0.33f;
+			float cheby = mpdsp::chebyshev(5, std::sin(2.0f * M_PI * t));
+			float folded = std::sin(2.0f * M_PI * t) * (1.0f + blend * 2.0f);
+			while (folded > 1.0f) folded = 2.0f - folded;
+			while (folded < -1.0f) folded = -2.0f - folded;
+			sample = cheby * (1.0f - blend) + folded * blend;
+		}
+		else {
+			// Folded to impulses (0.66 - 1.0)
+			float blend = (topology - 0.66f) / 0.34f;
+			float folded = std::sin(2.0f * M_PI * t) * 3.0f;
+			while (folded > 1.0f) folded = 2.0f - folded;
+			while (folded < -1.0f) folded = -2.0f - folded;
+			
+			// Discontinuous impulses
+			float impulse = (t < 0.1f) ? 1.0f : -0.1f;
+			sample = folded * (1.0f - blend) + impulse * blend;
+		}
+		
+		frame[i] = sample;
+	}
+}
+
+// Frames at evenly spaced topology settings; reads crossfade between them
+struct TopologyFrames : SonogeneseModule::TopologyBank {
+	TopologyFrames() : SonogeneseModule::TopologyBank(SonogeneseModule::TOPOLOGY_FRAMES) {
+		for (int k = 0; k < frames; k++) {
+			generateWavetable((float)k / (frames - 1), frame(k));
+		}
+	}
+};
+
+const SonogeneseModule::TopologyBank* getTopologyBank() {
+	static const TopologyFrames bank;
+	return &bank;
+}
+
+} // namespace
+
 SonogeneseModule::SonogeneseModule() {
 	config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 	
@@ -21,13 +79,58 @@ SonogeneseModule::SonogeneseModule() {
 	configInput(BLOOM_INPUT, "Bloom CV");
 	configOutput(AUDIO_OUTPUT, "Audio");
 	
-	// Initialize wavetable
-	generateWavetable(0.0f);
+	fragmentationParam.config(FRAGMENTATION_PARAM, FRAGMENTATION_INPUT, FRAGMENTATION_ATTEN_PARAM);
+	topologyParam.config(TOPOLOGY_PARAM, TOPOLOGY_INPUT, TOPOLOGY_ATTEN_PARAM);
+	skewParam.config(SKEW_PARAM, SKEW_INPUT, SKEW_ATTEN_PARAM);
+	bloomParam.config(BLOOM_PARAM, BLOOM_INPUT, BLOOM_ATTEN_PARAM);
+	controlDivider.setDivision(mpdsp::CONTROL_BLOCK_SIZE);
+	
+	delayLine.resize(DELAY_SIZE);
+	
+	// Shared wavetable frames and lookup tables
+	topologyBank = getTopologyBank();
+	topologyCursor = topologyBank->locate(0.0f);
+	tables = mpdsp::sharedTables();
 	
 	// Initialize harmonic amplitudes (natural harmonic series)
 	for (int i = 0; i < MAX_HARMONICS; i++) {
-		harmonicAmps[i] = 1.0f / (i + 1.0f);
+		harmonicAmps[i / 4][i % 4] = 1.0f / (i + 1.0f);
 	}
+	
+	rng.setSeed(random::u64());
+	applyQuality(mpdsp::resolveQuality(quality));
+}
+
+json_t* SonogeneseModule::dataToJson() {
+	json_t* rootJ = json_object();
+	mpdsp::seedToJson(rootJ, rng, id);
+	json_object_set_new(rootJ, "quality", json_integer(quality));
+	return rootJ;
+}
+
+void SonogeneseModule::dataFromJson(json_t* rootJ) {
+	uint64_t seed;
+	if (mpdsp::seedFromJson(rootJ, id, &seed)) {
+		rng.setSeed(seed);
+	}
+	
+	json_t* qualityJ = json_object_get(rootJ, "quality");
+	if (qualityJ) {
+		quality = clamp((int)json_integer_value(qualityJ), mpdsp::QUALITY_DEFAULT, mpdsp::NUM_QUALITIES - 1);
+	}
+}
+
+void SonogeneseModule::applyQuality(int tier) {
+	// Eco keeps the lower half of the bloom harmonics and reads knobs half as
+	// often; High reads them twice as often and interpolates the skew cubically
+	static const int HARMONIC_GROUP_COUNTS[mpdsp::NUM_QUALITIES] = {HARMONIC_GROUPS / 2, HARMONIC_GROUPS, HARMONIC_GROUPS};
+	static const int CONTROL_BLOCK_SIZES[mpdsp::NUM_QUALITIES] = {64, 32, 16};
+	appliedQuality = tier;
+	activeHarmonicGroups = HARMONIC_GROUP_COUNTS[tier];
+	// The bloom gain depends on the harmonic count
+	bloomParam.reset();
+	cubicSkew = (tier == mpdsp::QUALITY_HIGH);
+	controlDivider.setDivision(CONTROL_BLOCK_SIZES[tier]);
 }
 
 void SonogeneseModule::process(const ProcessArgs& args) {
@@ -38,43 +141,29 @@ void SonogeneseModule::process(const ProcessArgs& args) {
 	if (inputs[VOCT_INPUT].isConnected()) {
 		pitch = inputs[VOCT_INPUT].getVoltage();
 	}
-	frequency = dsp::FREQ_C4 * std::pow(2.0f, pitch);
+	frequency = dsp::FREQ_C4 * mpdsp::exp2(pitch);
 	
 	// Get parameters with CV and attenuverters
-	float fragmentation = params[FRAGMENTATION_PARAM].getValue();
-	if (inputs[FRAGMENTATION_INPUT].isConnected()) {
-		float cv = inputs[FRAGMENTATION_INPUT].getVoltage() / 10.0f;
-		float atten = params[FRAGMENTATION_ATTEN_PARAM].getValue();
-		fragmentation = clamp(fragmentation + cv * atten, 0.0f, 1.0f);
-	}
-	
-	float topology = params[TOPOLOGY_PARAM].getValue();
-	if (inputs[TOPOLOGY_INPUT].isConnected()) {
-		float cv = inputs[TOPOLOGY_INPUT].getVoltage() / 10.0f;
-		float atten = params[TOPOLOGY_ATTEN_PARAM].getValue();
-		topology = clamp(topology + cv * atten, 0.0f, 1.0f);
+	bool blockStart = controlDivider.process();
+	if (blockStart && mpdsp::resolveQuality(quality) != appliedQuality) {
+		applyQuality(mpdsp::resolveQuality(quality));
 	}
-	
-	float skew = params[SKEW_PARAM].getValue();
-	if (inputs[SKEW_INPUT].isConnected()) {
-		float cv = inputs[SKEW_INPUT].getVoltage() / 10.0f;
-		float atten = params[SKEW_ATTEN_PARAM].getValue();
-		skew = clamp(skew + cv * atten, 0.0f, 1.0f);
+	int blockSize = (int)controlDivider.getDivision();
+	float fragmentation = fragmentationParam.process(this, blockStart, blockSize);
+	float topology = topologyParam.process(this, blockStart, blockSize);
+	float skew = skewParam.process(this, blockStart, blockSize);
+	float bloom = bloomParam.process(this, blockStart, blockSize);
+	
+	// Pick the wavetable frame pair for this topology
+	if (topologyParam.changed()) {
+		topologyCursor = topologyBank->locate(topology * (TOPOLOGY_FRAMES - 1));
 	}
-	
-	float bloom = params[BLOOM_PARAM].getValue();
-	if (inputs[BLOOM_INPUT].isConnected()) {
-		float cv = inputs[BLOOM_INPUT].getVoltage() / 10.0f;
-		float atten = params[BLOOM_ATTEN_PARAM].getValue();
-		bloom = clamp(bloom + cv * atten, 0.0f, 1.0f);
-	}
-	
-	// Update wavetable if topology changed significantly
-	static float lastTopology = 0.0f;
-	if (std::abs(topology - lastTopology) > 0.01f) {
-		generateWavetable(topology);
-		lastTopology = topology;
+	if (bloomParam.targetChanged()) {
+		updateBloom(bloomParam.target(), blockSize, bloomParam.restartedBlock());
 	}
+	bloomAmps.process();
+	bloomDetune.process();
+	bloomGain.process();
 	
 	// ================================================================
 	// SIGNAL GENERATION CHAIN
@@ -87,7 +176,7 @@ void SonogeneseModule::process(const ProcessArgs& args) {
 		output = applySpectralBloom(frequency, bloom, args.sampleRate);
 	} else {
 		// Simple sine base when bloom is off
-		output = std::sin(2.0f * M_PI * phase);
+		output = tables->sin2pi(phase);
 	}
 	
 	// Stage 2: Fragmentation (granular micro-segmentation)
@@ -113,46 +202,6 @@ void SonogeneseModule::process(const ProcessArgs& args) {
 // DSP HELPER FUNCTIONS
 // ================================================================
 
-void SonogeneseModule::generateWavetable(float topology) {
-	// Generate morphing wavetable based on topology parameter
-	// sine → Chebyshev → folded → impulses
-	
-	for (int i = 0; i < WAVETABLE_SIZE; i++) {
-		float t = (float)i / WAVETABLE_SIZE;
-		float sample = 0.0f;
-		
-		if (topology < 0.33f) {
-			// Sine to Chebyshev blend (0.0 - 0.33)
-			float blend = topology / 0.33f;
-			float sine = std::sin(2.0f * M_PI * t);
-			float cheby = chebyshevPolynomial(5, std::sin(2.0f * M_PI * t));
-			sample = sine * (1.0f - blend) + cheby * blend;
-		}
-		else if (topology < 0.66f) {
-			// Chebyshev to folded (0.33 - 0.66)
-			float blend = (topology - 0.33f) / 0.33f;
-			float cheby = chebyshevPolynomial(5, std::sin(2.0f * M_PI * t));
-			float folded = std::sin(2.0f * M_PI * t) * (1.0f + blend * 2.0f);
-			while (folded > 1.0f) folded = 2.0f - folded;
-			while (folded < -1.0f) folded = -2.0f - folded;
-			sample = cheby * (1.0f - blend) + folded * blend;
-		}
-		else {
-			// Folded to impulses (0.66 - 1.0)
-			float blend = (topology - 0.66f) / 0.34f;
-			float folded = std::sin(2.0f * M_PI * t) * 3.0f;
-			while (folded > 1.0f) folded = 2.0f - folded;
-			while (folded < -1.0f) folded = -2.0f - folded;
-			
-			// Discontinuous impulses
-			float impulse = (t < 0.1f) ? 1.0f : -0.1f;
-			sample = folded * (1.0f - blend) + impulse * blend;
-		}
-		
-		wavetable[i] = sample;
-	}
-}
-
 float SonogeneseModule::processFragmentation(float phase, float fragAmount) {
 	// Granular micro-segmentation with jittered grain lengths
 	
@@ -161,7 +210,7 @@ float SonogeneseModule::processFragmentation(float phase, float fragAmount) {
 	
 	// Add jitter to grain position
 	float jitter = fragAmount * 0.3f;
-	int jitterOffset = (int)(random::uniform() * jitter * baseGrainLength);
+	int jitterOffset = (int)(rng.uniform() * jitter * baseGrainLength);
 	
 	// Calculate grain read position with crossfade
 	int readPos = (grainPos + jitterOffset) % WAVETABLE_SIZE;
@@ -169,10 +218,10 @@ float SonogeneseModule::processFragmentation(float phase, float fragAmount) {
 	
 	// Crossfade between grains
 	float grainWindow = grainPhase / baseGrainLength;
-	float window = 0.5f - 0.5f * std::cos(M_PI * 2.0f * grainWindow);
+	float window = tables->hann(grainWindow);
 	
-	float sample = wavetable[readPos] * (1.0f - grainCrossfade) + 
-	               wavetable[nextReadPos] * grainCrossfade;
+	float sample = TopologyBank::at(topologyCursor, readPos) * (1.0f - grainCrossfade) + 
+	               TopologyBank::at(topologyCursor, nextReadPos) * grainCrossfade;
 	sample *= window;
 	
 	// Advance grain
@@ -180,7 +229,7 @@ float SonogeneseModule::processFragmentation(float phase, float fragAmount) {
 	if (grainPhase >= baseGrainLength) {
 		grainPhase = 0.0f;
 		grainPos = (int)(phase * WAVETABLE_SIZE) % WAVETABLE_SIZE;
-		grainCrossfade = random::uniform();
+		grainCrossfade = rng.uniform();
 	}
 	
 	return sample;
@@ -193,7 +242,7 @@ float SonogeneseModule::applyTopologyWarp(float sample, float topology) {
 	
 	// Apply Chebyshev polynomial warping
 	int order = (int)(topology * 7.0f) + 2; // Orders 2-9
-	float warped = chebyshevPolynomial(order, sample);
+	float warped = mpdsp::chebyshev(order, sample);
 	
 	return sample * (1.0f - topology * 0.5f) + warped * (topology * 0.5f);
 }
@@ -202,8 +251,7 @@ float SonogeneseModule::applyTemporalSkew(float sample, float skew, float sample
 	// Nonlinear phase distortion using delay line scrubbing
 	
 	// Write to delay line
-	delayLine[delayWritePos] = sample;
-	delayWritePos = (delayWritePos + 1) % DELAY_SIZE;
+	delayLine.push(sample);
 	
 	if (skew < 0.01f) return sample;
 	
@@ -212,73 +260,62 @@ float SonogeneseModule::applyTemporalSkew(float sample, float skew, float sample
 	float delayTime = std::abs(skewAmount) * 100.0f; // Up to 100 samples delay
 	
 	// Nonlinear time warping
-	float warpedDelay = delayTime * (1.0f + std::sin(phase * 2.0f * M_PI) * skewAmount);
-	warpedDelay = clamp(warpedDelay, 1.0f, (float)(DELAY_SIZE - 1));
+	float warpedDelay = delayTime * (1.0f + mpdsp::sin2pi(phase) * skewAmount);
+	warpedDelay = clamp(warpedDelay, 1.0f, (float)(DELAY_SIZE - 2));
 	
-	int readPos = (delayWritePos - (int)warpedDelay + DELAY_SIZE) % DELAY_SIZE;
-	float frac = warpedDelay - (int)warpedDelay;
-	int nextReadPos = (readPos - 1 + DELAY_SIZE) % DELAY_SIZE;
-	
-	float skewed = delayLine[readPos] * (1.0f - frac) + delayLine[nextReadPos] * frac;
+	float skewed = cubicSkew ? delayLine.readCubic(warpedDelay) : delayLine.readLinear(warpedDelay);
 	
 	return sample * (1.0f - std::abs(skewAmount)) + skewed * std::abs(skewAmount);
 }
 
-float SonogeneseModule::applySpectralBloom(float baseFreq, float bloom, float sampleRate) {
-	// Additive harmonic synthesis with extreme dynamic spreading
-	
-	float output = 0.0f;
-	
-	// Bloom controls harmonic spread and amplitude distribution
-	float spread = 1.0f + bloom * 8.0f; // Spread harmonics outward (up to 9x)
-	
-	for (int i = 0; i < MAX_HARMONICS; i++) {
-		float harmonicFreq = baseFreq * (i + 1) * spread;
-		
-		// Don't exceed Nyquist
-		if (harmonicFreq > sampleRate * 0.45f) break;
-		
-		// Update harmonic phase
-		harmonicPhases[i] += harmonicFreq / sampleRate;
-		while (harmonicPhases[i] >= 1.0f) harmonicPhases[i] -= 1.0f;
-		
-		// Amplitude varies dramatically with bloom
-		float amplitude = harmonicAmps[i];
+void SonogeneseModule::updateBloom(float bloom, int blockSize, bool jump) {
+	// Amplitude varies dramatically with bloom
+	for (int g = 0; g < HARMONIC_GROUPS; g++) {
+		simd::float_4 index(4 * g, 4 * g + 1, 4 * g + 2, 4 * g + 3);
 		if (bloom > 0.5f) {
 			// Expand: boost higher harmonics dramatically
-			amplitude *= (1.0f + (bloom - 0.5f) * i * 1.5f);
+			bloomAmps.target[g] = harmonicAmps[g] * (1.0f + (bloom - 0.5f) * index * 1.5f);
 		} else {
 			// Collapse: emphasize fundamentals, reduce higher
-			amplitude *= (1.0f - (0.5f - bloom) * i * 0.8f);
+			bloomAmps.target[g] = harmonicAmps[g] * (1.0f - (0.5f - bloom) * index * 0.8f);
 		}
 		
 		// Add slight detuning for organic character
-		float detune = bloom * 0.02f * (i % 3 - 1);
-		output += std::sin(2.0f * M_PI * (harmonicPhases[i] + detune)) * amplitude;
+		simd::float_4 detuneSteps((4 * g) % 3 - 1, (4 * g + 1) % 3 - 1, (4 * g + 2) % 3 - 1, (4 * g + 3) % 3 - 1);
+		bloomDetune.target[g] = bloom * 0.02f * detuneSteps;
 	}
 	
-	// Normalize with bloom-dependent scaling
-	return output / (MAX_HARMONICS * 0.3f * (1.0f + bloom));
+	// Normalize by the harmonics actually summed, with bloom-dependent scaling
+	bloomGain.target[0] = 1.0f / (activeHarmonicGroups * 4 * 0.3f * (1.0f + bloom));
+	
+	bloomAmps.start(blockSize, jump);
+	bloomDetune.start(blockSize, jump);
+	bloomGain.start(blockSize, jump);
 }
 
-float SonogeneseModule::chebyshevPolynomial(int n, float x) {
-	// Chebyshev polynomial of first kind
-	// T_0(x) = 1
-	// T_1(x) = x
-	// T_n(x) = 2x * T_{n-1}(x) - T_{n-2}(x)
-	
-	if (n == 0) return 1.0f;
-	if (n == 1) return x;
-	
-	float T0 = 1.0f;
-	float T1 = x;
-	float Tn = 0.0f;
-	
-	for (int i = 2; i <= n; i++) {
-		Tn = 2.0f * x * T1 - T0;
-		T0 = T1;
-		T1 = Tn;
+float SonogeneseModule::applySpectralBloom(float baseFreq, float bloom, float sampleRate) {
+	// Additive harmonic synthesis with extreme dynamic spreading
+	
+	// Bloom controls harmonic spread and amplitude distribution
+	float spread = 1.0f + bloom * 8.0f; // Spread harmonics outward (up to 9x)
+	float nyquist = sampleRate * 0.45f;
+	simd::float_4 sum = 0.0f;
+	
+	for (int g = 0; g < activeHarmonicGroups; g++) {
+		simd::float_4 index(4 * g, 4 * g + 1, 4 * g + 2, 4 * g + 3);
+		simd::float_4 harmonicFreq = baseFreq * (index + 1.0f) * spread;
+		
+		// Don't exceed Nyquist: harmonics rise with the index, so once the
+		// lowest of a group is over, the rest are too
+		if (harmonicFreq[0] > nyquist) break;
+		simd::float_4 audible = harmonicFreq <= nyquist;
+		
+		// Update harmonic phase
+		harmonicPhases[g] += simd::ifelse(audible, harmonicFreq / sampleRate, 0.0f);
+		harmonicPhases[g] -= simd::floor(harmonicPhases[g]);
+		
+		sum += simd::ifelse(audible, mpdsp::sin2pi(harmonicPhases[g] + bloomDetune.value[g]) * bloomAmps.value[g], 0.0f);
 	}
 	
-	return Tn;
+	return (sum[0] + sum[1] + sum[2] + sum[3]) * bloomGain.value[0];
 }
@@ -1,5 +1,13 @@
 #pragma once
 #include "plugin.hpp"
+#include "mpdsp/Chebyshev.hpp"
+#include "mpdsp/ControlParam.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/RandomStream.hpp"
+#include "mpdsp/FastMath.hpp"
+#include "mpdsp/Quality.hpp"
+#include "mpdsp/Tables.hpp"
+#include "mpdsp/WavetableBank.hpp"
 
 struct SonogeneseModule : Module {
 	enum ParamId {
@@ -33,32 +41,61 @@ struct SonogeneseModule : Module {
 	float phase = 0.f;
 	float frequency = 261.626f;  // C4
 	
-	// Wavetable grain engine
+	// Wavetable grain engine. The topology morph is precomputed as a bank of
+	// frames shared by every instance; the cursor holds this sample's pair
 	static const int WAVETABLE_SIZE = 2048;
-	float wavetable[WAVETABLE_SIZE];
+	static const int TOPOLOGY_FRAMES = 33;
+	typedef mpdsp::WavetableBank<WAVETABLE_SIZE> TopologyBank;
+	const TopologyBank* topologyBank;
+	TopologyBank::Cursor topologyCursor;
+	const mpdsp::Tables* tables;
 	int grainPos = 0;
 	float grainPhase = 0.f;
 	float grainLength = 512.f;
 	float grainCrossfade = 0.f;
 	
+	// Grain jitter randomness, seeded per instance and saved with the patch
+	mpdsp::RandomStream rng;
+	
 	// Delay line for temporal skew
 	static const int DELAY_SIZE = 4096;
-	float delayLine[DELAY_SIZE] = {};
-	int delayWritePos = 0;
+	mpdsp::DelayLine<float> delayLine;
+	bool cubicSkew = false;
 	
-	// Harmonic state for spectral bloom
+	// Harmonic state for spectral bloom, four harmonics per SIMD group
 	static const int MAX_HARMONICS = 16;
-	float harmonicPhases[MAX_HARMONICS] = {};
-	float harmonicAmps[MAX_HARMONICS] = {};
+	static const int HARMONIC_GROUPS = MAX_HARMONICS / 4;
+	simd::float_4 harmonicPhases[HARMONIC_GROUPS] = {};
+	simd::float_4 harmonicAmps[HARMONIC_GROUPS] = {};
+	// Bloom-shaped amplitudes, detune and gain, worked out once per control
+	// block when bloom moves and ramped across it
+	mpdsp::CoeffRamp<simd::float_4, HARMONIC_GROUPS> bloomAmps;
+	mpdsp::CoeffRamp<simd::float_4, HARMONIC_GROUPS> bloomDetune;
+	mpdsp::CoeffRamp<float, 1> bloomGain;
+	int activeHarmonicGroups = HARMONIC_GROUPS;
+	
+	// Knob and CV inputs, read at control rate
+	mpdsp::ControlParam fragmentationParam;
+	mpdsp::ControlParam topologyParam;
+	mpdsp::ControlParam skewParam;
+	mpdsp::ControlParam bloomParam;
+	dsp::ClockDivider controlDivider;
+	
+	// Quality tier, saved with the patch; appliedQuality is the tier the
+	// settings above were last sized for
+	int quality = mpdsp::QUALITY_DEFAULT;
+	int appliedQuality = -1;
 
 	SonogeneseModule();
 	void process(const ProcessArgs& args) override;
+	json_t* dataToJson() override;
+	void dataFromJson(json_t* rootJ) override;
+	void applyQuality(int tier);
 
 	// DSP functions
-	void generateWavetable(float topology);
 	float processFragmentation(float phase, float fragAmount);
 	float applyTopologyWarp(float sample, float topology);
 	float applyTemporalSkew(float sample, float skew, float sampleRate);
+	void updateBloom(float bloom, int blockSize, bool jump);
 	float applySpectralBloom(float baseFreq, float bloom, float sampleRate);
-	float chebyshevPolynomial(int n, float x);
 };
@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "SonogeneseModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
 	pluginInstance = p;
 	p->addModel(modelSonogenese);
 }
+#endif
 
 struct SonogeneseWidget : ModuleWidget {
 	SonogeneseWidget(SonogeneseModule* module) {
@@ -110,6 +113,19 @@ struct SonogeneseWidget : ModuleWidget {
 		outLabel->color = nvgRGB(200, 200, 200);
 		addChild(outLabel);
 	}
+
+	// Picks up default quality changes made from other plugins
+	void step() override {
+		mpdsp::pollDefaultQuality();
+		ModuleWidget::step();
+	}
+
+	void appendContextMenu(Menu* menu) override {
+		SonogeneseModule* module = getModule<SonogeneseModule>();
+
+		menu->addChild(new MenuSeparator);
+		mpdsp::appendQualityMenu(menu, &module->quality);
+	}
 };
 
 Model* modelSonogenese = createModel<SonogeneseModule, SonogeneseWidget>("Sonogenese");
@@ -1,6 +1,38 @@
 #include "TemporalisteModule.hpp"
 #include <cmath>
 
+namespace {
+
+// One cycle of fundamental + 2nd + 3rd harmonic, with a guard point for interpolation
+struct AccentTable {
+    float samples[TemporalisteModule::ACCENT_TABLE_SIZE + 1];
+    
+    AccentTable() {
+        for (int i = 0; i <= TemporalisteModule::ACCENT_TABLE_SIZE; i++) {
+            float phase = (float)i / TemporalisteModule::ACCENT_TABLE_SIZE;
+            samples[i] = std::sin(2.f * M_PI * phase)
+                + std::sin(2.f * M_PI * 2.f * phase) * 0.5f
+                + std::sin(2.f * M_PI * 3.f * phase) * 0.33f;
+        }
+    }
+};
+
+const float* getAccentTable() {
+    static const AccentTable table;
+    return table.samples;
+}
+
+// Layers 0-3 are the original divisive layers; the rest are Euclidean
+// patterns whose pulse count follows density
+const int LAYER_DIVISIONS[TemporalisteModule::MAX_LAYERS] = {1, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+const int LAYER_LENGTHS[TemporalisteModule::MAX_LAYERS] = {4, 8, 6, 16, 5, 7, 9, 11, 13, 3, 10, 12, 14, 15, 16, 6};
+
+// Steps per beat in PLL mode: quarters, eighths, eighth triplets and
+// sixteenths for the divisive layers; one layer runs at half time
+const float LAYER_RATES[TemporalisteModule::MAX_LAYERS] = {1.f, 2.f, 3.f, 4.f, 4.f, 4.f, 4.f, 4.f, 4.f, 0.5f, 4.f, 4.f, 2.f, 2.f, 4.f, 3.f};
+
+} // namespace
+
 TemporalisteModule::TemporalisteModule() {
     config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
     
@@ -16,6 +48,9 @@ TemporalisteModule::TemporalisteModule() {
     configParam(TIMESHIFT_PARAM, 0.f, 1.f, 0.2f, "Time-Space Shift");
     configParam(TIMESHIFT_ATTEN_PARAM, -1.f, 1.f, 0.f, "Shift CV Attenuator");
     
+    // Off-beats move back by up to half a step: 50% (straight) to 75%
+    configParam(SWING_PARAM, 0.f, 1.f, 0.f, "Swing (PLL clock)", "%", 0.f, 25.f, 50.f);
+    
     configInput(CLOCK_INPUT, "Clock");
     configInput(DENSITY_CV_INPUT, "Density CV");
     configInput(DRIFT_CV_INPUT, "Drift CV");
@@ -26,55 +61,123 @@ TemporalisteModule::TemporalisteModule() {
     configOutput(GATE2_OUTPUT, "Gate 2");
     configOutput(GATE3_OUTPUT, "Gate 3");
     configOutput(GATE4_OUTPUT, "Gate 4");
+    configOutput(POLY_OUTPUT, "Polyphonic gates");
     
+    // Built on the UI thread the first time a module is created
+    accentTable = getAccentTable();
+    
+    rng.setSeed(random::u64());
     onReset();
 }
 
 void TemporalisteModule::onReset() {
-    for (int i = 0; i < 4; i++) {
-        layers[i].stepCount = 0;
-        layers[i].phase = 0.f;
+    for (int i = 0; i < MAX_LAYERS; i++) {
         driftPhases[i] = 0.f;
-        timeshiftWriteIdx = 0;
+        gateQueues[i].clear();
+        gateGenerators[i].reset();
+        accentPhases[i] = 0.f;
+        // Force every output to be rewritten on the next sample
+        lastGateVoltages[i] = -1.f;
         
-        for (int j = 0; j < TIMESHIFT_BUFFER_SIZE; j++) {
-            timeshiftBuffers[i][j] = 0.f;
-        }
+        // Initialize rhythm layers with different divisions
+        layers[i].division = LAYER_DIVISIONS[i];
+        layers[i].patternLength = LAYER_LENGTHS[i];
+        layers[i].stepCount = 0;
+        layers[i].stepIndex = 0;
+        buildPattern(layers[i], 1);
     }
-    
-    for (int i = 0; i < ACCENT_BUFFER_SIZE; i++) {
-        accentBuffer[i] = 0.f;
+    busyMask = (1u << MAX_LAYERS) - 1;
+    lastDensity = -1.f;
+    beatClock.reset();
+}
+
+json_t* TemporalisteModule::dataToJson() {
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "numLayers", json_integer(numLayers));
+    json_object_set_new(rootJ, "clockMode", json_integer(clockMode));
+    mpdsp::seedToJson(rootJ, rng, id);
+    return rootJ;
+}
+
+void TemporalisteModule::dataFromJson(json_t* rootJ) {
+    json_t* numLayersJ = json_object_get(rootJ, "numLayers");
+    if (numLayersJ) {
+        setNumLayers((int)json_integer_value(numLayersJ));
     }
-    accentWriteIdx = 0;
-    
-    // Initialize rhythm layers with different divisions
-    layers[0].division = 1;  // Quarter notes
-    layers[0].patternLength = 4;
     
-    layers[1].division = 2;  // Eighth notes
-    layers[1].patternLength = 8;
+    json_t* clockModeJ = json_object_get(rootJ, "clockMode");
+    if (clockModeJ) {
+        setClockMode((int)json_integer_value(clockModeJ));
+    }
     
-    layers[2].division = 3;  // Triplets
-    layers[2].patternLength = 6;
+    uint64_t seed;
+    if (mpdsp::seedFromJson(rootJ, id, &seed)) {
+        rng.setSeed(seed);
+    }
+}
+
+void TemporalisteModule::setNumLayers(int count) {
+    numLayers = clamp(count, 1, MAX_LAYERS);
+    // Re-evaluate active layers on the next clock edge
+    lastDensity = -1.f;
+}
+
+void TemporalisteModule::setClockMode(int mode) {
+    clockMode = clamp(mode, 0, NUM_CLOCK_MODES - 1);
+    lastDensity = -1.f;
+}
+
+void TemporalisteModule::buildPattern(RhythmLayer& layer, int pulses) {
+    // Divisive layers fire every `division` steps; Euclidean layers spread
+    // `pulses` hits as evenly as possible over the pattern length
+    uint32_t pattern = 0;
+    for (int step = 0; step < layer.patternLength; step++) {
+        bool hit = (layer.division > 0)
+            ? (step % layer.division == 0)
+            : ((step * pulses) % layer.patternLength < pulses);
+        pattern |= (uint32_t)hit << step;
+    }
+    layer.pattern = pattern;
+    layer.pulses = pulses;
     
-    layers[3].division = 4;  // Sixteenth notes
-    layers[3].patternLength = 16;
+    // Keep the layer's position in the pattern
+    int step = layer.stepCount;
+    layer.cursor = (pattern >> step) | (pattern << (layer.patternLength - step));
+    layer.cursor &= (1u << layer.patternLength) - 1;
 }
 
 void TemporalisteModule::processPolyrhythmicDensity(float density) {
-    // Control how many layers are active (1-4)
-    // density 0.0 = 1 layer, 1.0 = 4 layers
-    int activeLayers = 1 + (int)(density * 3.f);
-    activeLayers = clamp(activeLayers, 1, 4);
-    
-    for (int i = 0; i < 4; i++) {
-        layers[i].active = (i < activeLayers);
+    // Patterns and probabilities only change with density or layer count
+    if (density == lastDensity) return;
+    lastDensity = density;
+    
+    // Control how many layers are active
+    // density 0.0 = 1 layer, 1.0 = all layers
+    int activeLayers = 1 + (int)(density * (float)(numLayers - 1));
+    activeLayers = clamp(activeLayers, 1, numLayers);
+    activeMask = (1u << activeLayers) - 1;
+    
+    for (int i = 0; i < numLayers; i++) {
+        // The PLL plays divisive layers on every step of their faster grid
+        if (LAYER_DIVISIONS[i] > 0) {
+            int division = (clockMode == CLOCK_PLL) ? 1 : LAYER_DIVISIONS[i];
+            if (division != layers[i].division) {
+                layers[i].division = division;
+                buildPattern(layers[i], 0);
+            }
+        }
+        
+        // Higher layers have lower probabilities
+        float layerProb = 1.f - (float)i * 0.45f / (float)std::max(numLayers - 1, 1);
+        layers[i].probability = layerProb * (0.5f + density * 0.5f);
         
-        // Adjust probabilities based on density
-        if (layers[i].active) {
-            // Higher layers have lower probabilities
-            float layerProb = 1.f - (float)i * 0.15f;
-            layers[i].probability = layerProb * (0.5f + density * 0.5f);
+        // Euclidean pulse count grows with density
+        if (layers[i].division == 0) {
+            int pulses = (int)(layers[i].patternLength * (0.2f + density * 0.4f) + 0.5f);
+            pulses = clamp(pulses, 1, layers[i].patternLength);
+            if (pulses != layers[i].pulses) {
+                buildPattern(layers[i], pulses);
+            }
         }
     }
 }
@@ -84,7 +187,7 @@ bool TemporalisteModule::processStochasticDrift(int layer, float drift) {
     // drift 0.0 = deterministic, 1.0 = highly stochastic
     
     // Generate random value for this layer
-    float randomValue = random::uniform();
+    float randomValue = rng.uniform();
     
     // Base probability from layer configuration
     float baseProb = layers[layer].probability;
@@ -101,7 +204,7 @@ bool TemporalisteModule::processStochasticDrift(int layer, float drift) {
     return (randomValue < driftedProb);
 }
 
-float TemporalisteModule::processSpectralAccent(int layer, float accent, bool gateActive) {
+float TemporalisteModule::processSpectralAccent(int layer, float accent, bool gateActive, float sampleTime) {
     // Apply spectral shaping to gate events
     // accent 0.0 = clean gates, 1.0 = complex harmonic content
     
@@ -111,112 +214,183 @@ float TemporalisteModule::processSpectralAccent(int layer, float accent, bool ga
     
     // Add harmonic complexity based on accent
     if (accent > 0.1f) {
-        // Generate harmonics at different frequencies
+        // Each layer reads the harmonic table at its own fundamental
         float fundamental = 100.f + (float)layer * 50.f;
-        float phase = (float)APP->engine->getFrame() / 48000.f;
-        
-        float harmonic1 = std::sin(2.f * M_PI * fundamental * phase);
-        float harmonic2 = std::sin(2.f * M_PI * fundamental * 2.f * phase) * 0.5f;
-        float harmonic3 = std::sin(2.f * M_PI * fundamental * 3.f * phase) * 0.33f;
+        accentPhases[layer] += fundamental * sampleTime;
+        if (accentPhases[layer] >= 1.f) accentPhases[layer] -= 1.f;
         
-        float spectral = harmonic1 + harmonic2 + harmonic3;
+        float readPos = accentPhases[layer] * ACCENT_TABLE_SIZE;
+        int idx = (int)readPos;
+        float frac = readPos - (float)idx;
+        float spectral = accentTable[idx] + (accentTable[idx + 1] - accentTable[idx]) * frac;
         spectral *= accent * 0.3f; // Mix in based on accent amount
         
         output += spectral;
     }
     
-    // Write to accent buffer for feedback/memory
-    accentBuffer[accentWriteIdx] = output;
-    accentWriteIdx = (accentWriteIdx + 1) % ACCENT_BUFFER_SIZE;
-    
     return output;
 }
 
-void TemporalisteModule::processTimeSpaceShift(int layer, float shift, float sampleTime) {
-    // Micro-timing offsets per layer
+void TemporalisteModule::scheduleBeat(double beatStart, double period, float sampleTime, int64_t frame) {
+    // Get parameters with CV
+    float density = mpdsp::cvParam(this, DENSITY_PARAM, DENSITY_CV_INPUT, DENSITY_ATTEN_PARAM);
+    float drift = mpdsp::cvParam(this, DRIFT_PARAM, DRIFT_CV_INPUT, DRIFT_ATTEN_PARAM);
+    float timeshift = mpdsp::cvParam(this, TIMESHIFT_PARAM, TIMESHIFT_CV_INPUT, TIMESHIFT_ATTEN_PARAM);
+    
+    // Off-beat steps are pushed back by up to half a step
+    float swing = params[SWING_PARAM].getValue() * 0.5f;
+    
+    processPolyrhythmicDensity(density);
+    
+    double beat = (double)beatClock.beatCount;
+    for (int i = 0; i < numLayers; i++) {
+        RhythmLayer& layer = layers[i];
+        double stepLength = 1.0 / LAYER_RATES[i];
+        
+        // Every step of this layer that starts inside the beat, placed at its
+        // fractional frame so rounding never accumulates
+        while ((double)layer.stepIndex * stepLength < beat + 1.0) {
+            double offset = std::max((double)layer.stepIndex * stepLength - beat, 0.0);
+            bool offBeat = (layer.stepIndex & 1) != 0;
+            layer.stepIndex++;
+            
+            if (!(layer.step() & (activeMask >> i))) continue;
+            if (!processStochasticDrift(i, drift)) continue;
+            
+            double due = beatStart + offset * period;
+            if (offBeat) {
+                due += swing * stepLength * period;
+            }
+            due += processTimeSpaceShift(i, timeshift, sampleTime, frame);
+            gateQueues[i].schedule((int64_t)std::floor(due + 0.5));
+            busyMask |= 1u << i;
+        }
+    }
+}
+
+int TemporalisteModule::processTimeSpaceShift(int layer, float shift, float sampleTime, int64_t frame) {
+    // Micro-timing offsets per layer, returned as a delay in samples
     // shift 0.0 = synchronized, 1.0 = maximum offset
     
     // Calculate per-layer delay offset (0-20ms)
     float layerDelay = shift * (float)(layer + 1) * 5.f; // 0-20ms range
     int delaySamples = (int)(layerDelay * 0.001f / sampleTime);
-    delaySamples = clamp(delaySamples, 0, TIMESHIFT_BUFFER_SIZE - 1);
     
     // Apply modulated micro-offset
-    float modulation = std::sin(2.f * M_PI * 0.37f * (float)layer * APP->engine->getFrame() * sampleTime);
+    float modulation = std::sin(2.f * M_PI * 0.37f * (float)layer * frame * sampleTime);
     int modulatedOffset = (int)(modulation * shift * 50.f);
     
-    layers[layer].phase = (float)(delaySamples + modulatedOffset) * sampleTime;
+    return std::max(delaySamples + modulatedOffset, 0);
 }
 
 void TemporalisteModule::process(const ProcessArgs& args) {
-    // Get parameters with CV
-    float density = params[DENSITY_PARAM].getValue();
-    if (inputs[DENSITY_CV_INPUT].isConnected()) {
-        density += inputs[DENSITY_CV_INPUT].getVoltage() * params[DENSITY_ATTEN_PARAM].getValue() * 0.1f;
-    }
-    density = clamp(density, 0.f, 1.f);
-    
-    float drift = params[DRIFT_PARAM].getValue();
-    if (inputs[DRIFT_CV_INPUT].isConnected()) {
-        drift += inputs[DRIFT_CV_INPUT].getVoltage() * params[DRIFT_ATTEN_PARAM].getValue() * 0.1f;
-    }
-    drift = clamp(drift, 0.f, 1.f);
-    
-    float accent = params[ACCENT_PARAM].getValue();
-    if (inputs[ACCENT_CV_INPUT].isConnected()) {
-        accent += inputs[ACCENT_CV_INPUT].getVoltage() * params[ACCENT_ATTEN_PARAM].getValue() * 0.1f;
+    // Rack ignores setChannels() on an unpatched port and resets the count
+    // to one when a cable goes in, so this is set on every sample. The
+    // outputs are rewritten in full when the layer count or the cable changes
+    outputs[POLY_OUTPUT].setChannels(numLayers);
+    bool polyConnected = outputs[POLY_OUTPUT].isConnected();
+    if (polyChannels != numLayers || polyWasConnected != polyConnected) {
+        polyChannels = numLayers;
+        polyWasConnected = polyConnected;
+        busyMask = (1u << MAX_LAYERS) - 1;
+        for (int i = 0; i < MAX_LAYERS; i++) {
+            lastGateVoltages[i] = -1.f;
+        }
     }
-    accent = clamp(accent, 0.f, 1.f);
     
-    float timeshift = params[TIMESHIFT_PARAM].getValue();
-    if (inputs[TIMESHIFT_CV_INPUT].isConnected()) {
-        timeshift += inputs[TIMESHIFT_CV_INPUT].getVoltage() * params[TIMESHIFT_ATTEN_PARAM].getValue() * 0.1f;
+    if (activeClockMode != clockMode) {
+        activeClockMode = clockMode;
+        beatClock.reset();
     }
-    timeshift = clamp(timeshift, 0.f, 1.f);
-    
-    // Process density to determine active layers
-    processPolyrhythmicDensity(density);
     
-    // Process time-space shift for all layers
-    for (int i = 0; i < 4; i++) {
-        processTimeSpaceShift(i, timeshift, args.sampleTime);
-    }
+    // Clock input processing; the rhythm parameters are only needed on clock edges
+    float clockVoltage = inputs[CLOCK_INPUT].getVoltage();
+    bool clockEdge = inputs[CLOCK_INPUT].isConnected() && clockTrigger.process(clockVoltage);
     
-    // Clock input processing
-    if (inputs[CLOCK_INPUT].isConnected()) {
-        if (clockTrigger.process(inputs[CLOCK_INPUT].getVoltage())) {
-            // Clock pulse received
+    if (activeClockMode == CLOCK_PLL) {
+        double now = (double)args.frame;
+        double beatStart;
+        if (beatClock.advance(now, beatStart)) {
+            scheduleBeat(beatStart, beatClock.period, args.sampleTime, args.frame);
+        }
+        
+        if (clockEdge) {
+            // Locate the 1V threshold crossing between the previous and current sample
+            float rise = clockVoltage - lastClockVoltage;
+            double frac = (rise > 0.f) ? clamp((1.f - lastClockVoltage) / rise, 0.f, 1.f) : 1.0;
+            double edgeTime = now - 1.0 + frac;
             
-            // Process each active layer
-            for (int i = 0; i < 4; i++) {
-                if (!layers[i].active) continue;
-                
-                // Check if this layer triggers on this clock pulse
-                bool shouldTrigger = (layers[i].stepCount % layers[i].division == 0);
-                
-                if (shouldTrigger) {
-                    // Apply stochastic drift
-                    bool gateFires = processStochasticDrift(i, drift);
-                    
-                    if (gateFires) {
-                        // Trigger gate with 10ms pulse
-                        gateGenerators[i].trigger(0.01f);
-                    }
+            if (beatClock.edge(edgeTime, now)) {
+                for (int i = 0; i < MAX_LAYERS; i++) {
+                    layers[i].stepIndex = 0;
                 }
-                
-                // Advance step counter
-                layers[i].stepCount = (layers[i].stepCount + 1) % layers[i].patternLength;
+                scheduleBeat(edgeTime, beatClock.period, args.sampleTime, args.frame);
+            }
+        }
+    }
+    else if (clockEdge) {
+        // Get parameters with CV
+        float density = mpdsp::cvParam(this, DENSITY_PARAM, DENSITY_CV_INPUT, DENSITY_ATTEN_PARAM);
+        float drift = mpdsp::cvParam(this, DRIFT_PARAM, DRIFT_CV_INPUT, DRIFT_ATTEN_PARAM);
+        float timeshift = mpdsp::cvParam(this, TIMESHIFT_PARAM, TIMESHIFT_CV_INPUT, TIMESHIFT_ATTEN_PARAM);
+        
+        // Process density to determine active layers
+        processPolyrhythmicDensity(density);
+        
+        // Gather the current step of every layer into one mask while
+        // rotating each cursor to its next step
+        uint32_t hits = 0;
+        for (int i = 0; i < numLayers; i++) {
+            hits |= layers[i].step() << i;
+        }
+        hits &= activeMask;
+        
+        // Only layers that hit this step pay for the stochastic decision
+        while (hits) {
+            int i = __builtin_ctz(hits);
+            hits &= hits - 1;
+            
+            // Apply stochastic drift
+            if (processStochasticDrift(i, drift)) {
+                // Schedule the gate at this layer's time-space shifted position
+                int delay = processTimeSpaceShift(i, timeshift, args.sampleTime, args.frame);
+                gateQueues[i].schedule(args.frame + delay);
+                busyMask |= 1u << i;
             }
         }
     }
+    lastClockVoltage = clockVoltage;
     
-    // Process gate outputs
-    for (int i = 0; i < 4; i++) {
+    // Nothing pending and all gates low: outputs already hold 0V
+    if (busyMask == 0) return;
+    
+    float accent = mpdsp::cvParam(this, ACCENT_PARAM, ACCENT_CV_INPUT, ACCENT_ATTEN_PARAM);
+    
+    uint32_t busy = busyMask;
+    while (busy) {
+        int i = __builtin_ctz(busy);
+        busy &= busy - 1;
+        
+        // Fire gates whose scheduled time has arrived (10ms pulse)
+        while (gateQueues[i].popDue(args.frame)) {
+            gateGenerators[i].trigger(0.01f);
+        }
+        
         bool gateActive = gateGenerators[i].process(args.sampleTime);
         
         // Apply spectral accent shaping
-        float gateVoltage = processSpectralAccent(i, accent, gateActive);
+        float gateVoltage = processSpectralAccent(i, accent, gateActive, args.sampleTime);
         
-        outputs[GATE1_OUTPUT + i].setVoltage(gateVoltage);
+        if (gateVoltage != lastGateVoltages[i]) {
+            if (i < 4) {
+                outputs[GATE1_OUTPUT + i].setVoltage(gateVoltage);
+            }
+            outputs[POLY_OUTPUT].setVoltage(gateVoltage, i);
+            lastGateVoltages[i] = gateVoltage;
+        }
+        
+        if (!gateActive && gateQueues[i].size == 0) {
+            busyMask &= ~(1u << i);
+        }
     }
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include <rack.hpp>
+#include "mpdsp/Aligned.hpp"
+#include "mpdsp/CvParam.hpp"
+#include "mpdsp/RandomStream.hpp"
 
 using namespace rack;
 
-struct TemporalisteModule : Module {
+struct TemporalisteModule : Module, mpdsp::CacheAligned {
     enum ParamIds {
         DENSITY_PARAM,
         DENSITY_ATTEN_PARAM,
@@ -13,6 +16,7 @@ struct TemporalisteModule : Module {
         ACCENT_ATTEN_PARAM,
         TIMESHIFT_PARAM,
         TIMESHIFT_ATTEN_PARAM,
+        SWING_PARAM,
         NUM_PARAMS
     };
     enum InputIds {
@@ -28,51 +32,192 @@ struct TemporalisteModule : Module {
         GATE2_OUTPUT,
         GATE3_OUTPUT,
         GATE4_OUTPUT,
+        POLY_OUTPUT,
         NUM_OUTPUTS
     };
     enum LightIds {
         NUM_LIGHTS
     };
+    enum ClockMode {
+        CLOCK_EDGE, // Layers step on incoming clock edges (divider)
+        CLOCK_PLL,  // Layers step on a phase-locked beat clock (multiplier)
+        NUM_CLOCK_MODES
+    };
 
-    // Clock and rhythm state
-    dsp::SchmittTrigger clockTrigger;
-    dsp::PulseGenerator gateGenerators[4];
+    // Up to 16 layers on the polyphonic output; the first four also drive GATE1-4
+    static constexpr int MAX_LAYERS = 16;
+    // Points per cycle of the spectral accent table
+    static constexpr int ACCENT_TABLE_SIZE = 1024;
     
-    // Polyrhythm layers (1-4 active)
+    // Phase-locked beat clock: one beat per incoming clock pulse. The period is
+    // measured between sub-sample edge times, phase errors are corrected by half
+    // at every edge, and each beat's layer steps are scheduled when it starts.
+    struct BeatClock {
+        double lastEdge = -1.0; // Fractional frame of the last clock edge
+        double period = 0.0;    // Samples per beat
+        double phase = 0.0;     // Position in the current beat, 0..1
+        int64_t beatCount = 0;
+        bool locked = false;
+        
+        void reset() {
+            lastEdge = -1.0;
+            period = 0.0;
+            phase = 0.0;
+            beatCount = 0;
+            locked = false;
+        }
+        
+        // Feeds an edge at fractional frame `time`; returns true when the clock
+        // has just locked, in which case a beat starts at `time`
+        bool edge(double time, double now) {
+            bool justLocked = false;
+            if (lastEdge >= 0.0) {
+                double measured = time - lastEdge;
+                if (!locked) {
+                    period = measured;
+                    phase = (now - time) / period;
+                    beatCount = 0;
+                    locked = true;
+                    justLocked = true;
+                }
+                else {
+                    // Snap to tempo jumps, smooth out jitter
+                    if (std::fabs(measured - period) > 0.2 * period) {
+                        period = measured;
+                    }
+                    else {
+                        period += 0.25 * (measured - period);
+                    }
+                    double phaseAtEdge = phase - (now - time) / period;
+                    double error = phaseAtEdge - std::floor(phaseAtEdge + 0.5);
+                    phase -= 0.5 * error;
+                }
+            }
+            lastEdge = time;
+            return justLocked;
+        }
+        
+        // Advances one sample; returns true when a new beat starts, with its
+        // fractional start frame in `beatStart`
+        bool advance(double now, double& beatStart) {
+            if (!locked) return false;
+            // Clock stopped: forget the old edge too, so the pause is not
+            // measured as a period and relocking takes two fresh edges
+            if (now - lastEdge > 2.5 * period) {
+                reset();
+                return false;
+            }
+            phase += 1.0 / period;
+            if (phase < 1.0) return false;
+            phase -= 1.0;
+            beatCount++;
+            beatStart = now - phase * period;
+            return true;
+        }
+    };
+    
+    // Polyrhythm layers; each pattern is a step bitmask (bit 0 = first step).
+    // cursor holds the pattern rotated so bit 0 is the current step, which
+    // lets one clock edge resolve every layer with shifts and masks.
     struct RhythmLayer {
-        int division = 1;      // Clock division ratio
-        int stepCount = 0;     // Current step in pattern
+        int division = 1;      // Clock division ratio (0 = Euclidean)
         int patternLength = 4; // Steps per pattern
+        int pulses = 0;        // Euclidean pulse count the pattern was built for
+        int stepCount = 0;     // Current step in pattern
+        int64_t stepIndex = 0; // Steps taken since the beat clock locked
+        uint32_t pattern = 1;  // Step bitmask
+        uint32_t cursor = 1;   // Pattern rotated to the current step
         float probability = 1.f; // Gate probability
-        float phase = 0.f;     // Timing phase offset
-        bool active = true;
+        
+        // Returns whether the current step is a hit and moves to the next one
+        uint32_t step() {
+            int last = patternLength - 1;
+            uint32_t hit = cursor & 1u;
+            cursor = (cursor >> 1) | (hit << last);
+            stepCount = (stepCount + 1) * (stepCount < last);
+            return hit;
+        }
     };
     
-    RhythmLayer layers[4];
-    
-    // Stochastic drift
-    float driftPhases[4] = {};
+    // Pending gate-on events for one layer, kept ordered by due frame in a
+    // fixed-capacity ring so scheduling never allocates on the audio thread
+    struct GateEventQueue {
+        static constexpr int CAPACITY = 16; // Power of two
+        // Ahead of the events, so the next due frame is on the same line
+        int head = 0;
+        int size = 0;
+        int64_t dueFrames[CAPACITY] = {};
+        
+        void clear() {
+            head = 0;
+            size = 0;
+        }
+        
+        // Insert in due order; the event is dropped when the queue is full
+        bool schedule(int64_t frame) {
+            if (size == CAPACITY) return false;
+            int i = size++;
+            while (i > 0) {
+                int prev = (head + i - 1) & (CAPACITY - 1);
+                if (dueFrames[prev] <= frame) break;
+                dueFrames[(head + i) & (CAPACITY - 1)] = dueFrames[prev];
+                i--;
+            }
+            dueFrames[(head + i) & (CAPACITY - 1)] = frame;
+            return true;
+        }
+        
+        // Pops the earliest event if it is due at or before the given frame
+        bool popDue(int64_t frame) {
+            if (size == 0 || dueFrames[head] > frame) return false;
+            head = (head + 1) & (CAPACITY - 1);
+            size--;
+            return true;
+        }
+    };
     
-    // Spectral accent shaping
-    static constexpr int ACCENT_BUFFER_SIZE = 4096;
-    float accentBuffer[ACCENT_BUFFER_SIZE] = {};
-    int accentWriteIdx = 0;
+    // Read on every sample, together and starting on a cache line; while no
+    // layer is busy this is all that is touched. busyMask holds the layers
+    // with a pending event or a high gate
+    alignas(mpdsp::CACHE_LINE) uint32_t busyMask = 0;
+    int numLayers = 4;
+    int polyChannels = 0;
+    bool polyWasConnected = false;
+    int clockMode = CLOCK_EDGE;
+    int activeClockMode = CLOCK_EDGE;
+    float lastClockVoltage = 0.f;
+    dsp::SchmittTrigger clockTrigger;
+    BeatClock beatClock;
     
-    // Time-space shift buffers for micro-timing
-    static constexpr int TIMESHIFT_BUFFER_SIZE = 8192;
-    float timeshiftBuffers[4][TIMESHIFT_BUFFER_SIZE] = {};
-    int timeshiftWriteIdx = 0;
+    // Read every sample for busy layers only. Outputs are only rewritten
+    // when their voltage changes. Spectral accent: table oscillator per layer
+    // (table shared by all instances)
+    const float* accentTable = nullptr;
+    dsp::PulseGenerator gateGenerators[MAX_LAYERS];
+    float lastGateVoltages[MAX_LAYERS] = {};
+    float accentPhases[MAX_LAYERS] = {};
+    GateEventQueue gateQueues[MAX_LAYERS];
     
-    // Random state
-    dsp::SampleRateConverter<1> driftRandom;
+    // Read on clock edges and beats
+    RhythmLayer layers[MAX_LAYERS];
+    uint32_t activeMask = 0;
+    float lastDensity = -1.f;
+    float driftPhases[MAX_LAYERS] = {};
+    mpdsp::RandomStream rng; // Drift decisions; seed is saved with the patch
 
     TemporalisteModule();
     void process(const ProcessArgs& args) override;
     void onReset() override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void setNumLayers(int count);
+    void setClockMode(int mode);
     
     // DSP processors
+    void buildPattern(RhythmLayer& layer, int pulses);
     void processPolyrhythmicDensity(float density);
+    void scheduleBeat(double beatStart, double period, float sampleTime, int64_t frame);
     bool processStochasticDrift(int layer, float drift);
-    float processSpectralAccent(int layer, float accent, bool gateActive);
-    void processTimeSpaceShift(int layer, float shift, float sampleTime);
+    float processSpectralAccent(int layer, float accent, bool gateActive, float sampleTime);
+    int processTimeSpaceShift(int layer, float shift, float sampleTime, int64_t frame);
 };
@@ -1,12 +1,15 @@
 #include "plugin.hpp"
 #include "TemporalisteModule.hpp"
 
+// The combined plugin in Bundle/ defines its own instance and init()
+#ifndef COMBINED_PLUGIN
 Plugin* pluginInstance;
 
 void init(Plugin* p) {
     pluginInstance = p;
     p->addModel(modelTemporaliste);
 }
+#endif
 
 struct TemporalisteWidget : ModuleWidget {
     TemporalisteWidget(TemporalisteModule* module) {
@@ -51,6 +54,10 @@ struct TemporalisteWidget : ModuleWidget {
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(24.0f, 103.0f)), module, TemporalisteModule::ACCENT_CV_INPUT));
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(32.5f, 103.0f)), module, TemporalisteModule::TIMESHIFT_CV_INPUT));
 
+        // Swing and polyphonic gate output (between main knobs and attenuverters)
+        addParam(createParamCentered<Trimpot>(mm2px(Vec(7.0f, 66.5f)), module, TemporalisteModule::SWING_PARAM));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(19.64f, 66.5f)), module, TemporalisteModule::POLY_OUTPUT));
+
         // Clock input (centered, matching SVG cy=250)
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(19.64f, 84.8f)), module, TemporalisteModule::CLOCK_INPUT));
         
@@ -133,6 +140,25 @@ struct TemporalisteWidget : ModuleWidget {
         g4Label->color = nvgRGB(200, 200, 200);
         addChild(g4Label);
     }
+
+    void appendContextMenu(Menu* menu) override {
+        TemporalisteModule* module = getModule<TemporalisteModule>();
+
+        std::vector<std::string> layerLabels;
+        for (int i = 1; i <= TemporalisteModule::MAX_LAYERS; i++) {
+            layerLabels.push_back(std::to_string(i));
+        }
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createIndexSubmenuItem("Layers", layerLabels,
+            [=]() { return (size_t)(module->numLayers - 1); },
+            [=](size_t index) { module->setNumLayers((int)index + 1); }
+        ));
+        menu->addChild(createIndexSubmenuItem("Clock", {"Divide (step per pulse)", "Phase-locked (pulse per beat)"},
+            [=]() { return (size_t)module->clockMode; },
+            [=](size_t index) { module->setClockMode((int)index); }
+        ));
+    }
 };
 
 Model* modelTemporaliste = createModel<TemporalisteModule, TemporalisteWidget>("Temporaliste");
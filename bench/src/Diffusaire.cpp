@@ -0,0 +1,2 @@
+// DiffusaireModule for the benchmarks, without the plugin registration
+#include "../../Diffusaire/src/DiffusaireModule.cpp"
@@ -0,0 +1,2 @@
+// DubBoiteModule for the benchmarks, without the plugin registration
+#include "../../DubBoite/src/DubBoiteModule.cpp"
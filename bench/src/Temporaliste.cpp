@@ -0,0 +1,2 @@
+// TemporalisteModule for the benchmarks, without the plugin registration
+#include "../../Temporaliste/src/TemporalisteModule.cpp"
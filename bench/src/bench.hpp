@@ -0,0 +1,125 @@
+#pragma once
+#include <rack.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Small timing harness shared by the benchmark suites. Times are wall clock,
+// best of a few runs, so a stray context switch does not skew a line
+
+using namespace rack;
+
+namespace bench {
+
+// Makes the compiler treat a value as used, so the work that produced it
+// cannot be dropped or hoisted out of the timing loop
+template <typename T>
+inline void keep(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+m"(value) : : "memory");
+#else
+    volatile T sink = value;
+    (void)sink;
+#endif
+}
+
+// Nanoseconds per call of fn(i) for i in 0..calls-1
+template <typename F>
+double nsPerCall(int calls, F fn, int runs = 5) {
+    double best = 1e30;
+    for (int r = 0; r < runs; r++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; i++) {
+            fn(i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / calls);
+    }
+    return best;
+}
+
+// Largest absolute and relative difference from a reference
+struct ErrorStats {
+    double maxAbs = 0.0;
+    double maxRel = 0.0;
+
+    void add(double value, double reference) {
+        double error = std::fabs(value - reference);
+        maxAbs = std::max(maxAbs, error);
+        if (reference != 0.0) {
+            maxRel = std::max(maxRel, error / std::fabs(reference));
+        }
+    }
+};
+
+// Fixed pseudo-random input in -1..1, the same on every run
+struct Noise {
+    static const int SIZE = 4096;
+    float values[SIZE];
+
+    Noise() {
+        uint32_t state = 22222;
+        for (int i = 0; i < SIZE; i++) {
+            state = state * 1664525u + 1013904223u;
+            values[i] = (float)(state >> 8) / 8388608.f - 1.f;
+        }
+    }
+
+    float at(int i) const {
+        return values[i & (SIZE - 1)];
+    }
+
+    simd::float_4 at4(int i) const {
+        return simd::float_4::load(&values[(i * 4) & (SIZE - 4)]);
+    }
+};
+
+// The modules run at 48 kHz, as in a default Rack setup
+static const float SAMPLE_RATE = 48000.f;
+
+inline Module::ProcessArgs processArgs() {
+    Module::ProcessArgs args;
+    args.sampleRate = SAMPLE_RATE;
+    args.sampleTime = 1.f / SAMPLE_RATE;
+    args.frame = 0;
+    return args;
+}
+
+inline Module::SampleRateChangeEvent sampleRateChange() {
+    Module::SampleRateChangeEvent e;
+    e.sampleRate = SAMPLE_RATE;
+    e.sampleTime = 1.f / SAMPLE_RATE;
+    return e;
+}
+
+// Plugs a mono cable into a port. Port::setChannels() leaves an unpatched
+// port alone, so the count is set directly, as Engine::addCable() does
+inline void patch(engine::Port& port) {
+    port.channels = 1;
+}
+
+// Stops the run if a port a benchmark relies on is unpatched, rather than
+// timing a module that returns early
+inline void requirePatched(engine::Port& port, const char* what) {
+    if (!port.isConnected()) {
+        std::fprintf(stderr, "bench: %s is not patched\n", what);
+        std::exit(1);
+    }
+}
+
+inline void title(const char* text) {
+    std::printf("\n%s\n", text);
+}
+
+inline void line(const char* name, double ns, const char* unit) {
+    std::printf("  %-40s %9.2f ns/%s\n", name, ns, unit);
+}
+
+// Entry points of the suites, run by name from main.cpp
+void runPrimitives();
+void runFastMath();
+void runDenormal();
+void runInstances();
+
+} // namespace bench
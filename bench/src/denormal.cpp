@@ -0,0 +1,132 @@
+#include "bench.hpp"
+#include <vector>
+#if defined __SSE__
+#include <xmmintrin.h>
+#endif
+#include "mpdsp/AllPass.hpp"
+#include "mpdsp/Svf.hpp"
+#include "../../Diffusaire/src/DiffusaireModule.hpp"
+#include "../../DubBoite/src/DubBoiteModule.hpp"
+
+// Feeds each recursive stage an impulse, then ten seconds of silence, and
+// times every block of it. The decaying states pass through the subnormal
+// range on the way to zero; with flushDenormal() in the feedback paths the
+// cost per sample has to stay flat (or drop, once a module goes idle)
+// instead of jumping up once the tail gets quiet
+
+namespace bench {
+
+namespace {
+
+const int BLOCK = 4096;
+const int BLOCKS = 120;
+const int RUNS = 5;
+
+// Rack turns flush-to-zero and denormals-are-zero on for its engine threads,
+// and the -funsafe-math-optimizations link does the same for this program.
+// Clear both (MXCSR bits 15 and 6) so a subnormal costs what it would on a
+// host that leaves them alone
+void allowDenormals() {
+#if defined __SSE__
+    _mm_setcsr(_mm_getcsr() & ~0x8040u);
+#endif
+}
+
+// The whole response is run a few times from a fresh state and each block
+// keeps its fastest time, so a context switch does not read as a slowdown
+template <typename R, typename F>
+void impulse(const char* name, R reset, F process) {
+    std::vector<double> ns(BLOCKS, 1e30);
+    for (int run = 0; run < RUNS; run++) {
+        reset();
+        process(1.f);
+        for (int b = 0; b < BLOCKS; b++) {
+            ns[b] = std::min(ns[b], nsPerCall(BLOCK, [&](int) {
+                process(0.f);
+            }, 1));
+        }
+    }
+    int slowest = 0;
+    for (int b = 1; b < BLOCKS; b++) {
+        if (ns[b] > ns[slowest]) slowest = b;
+    }
+    bool flat = ns[slowest] < 1.5 * ns[0];
+    std::printf("  %-30s first %7.2f  slowest %7.2f at %5.2f s  last %7.2f ns/sample  %s\n",
+        name, ns[0], ns[slowest], (slowest + 1) * BLOCK / SAMPLE_RATE, ns[BLOCKS - 1], flat ? "flat" : "RISES");
+}
+
+} // namespace
+
+void runDenormal() {
+    allowDenormals();
+    title("Impulse then silence, flush-to-zero off (ns/sample per block)");
+
+    // A long all-pass decay: 0.999 per sample reaches the subnormals after
+    // about two seconds
+    mpdsp::AllPass1<float> allPass;
+    impulse("AllPass1", [&]() {
+        allPass.reset();
+    }, [&](float x) {
+        float y = allPass.process(x, 0.999f);
+        keep(y);
+    });
+
+    // Low, resonant cutoff, so the ring-down takes a few seconds
+    mpdsp::Svf<float> svf;
+    svf.setCutoff(0.001f, 5.f);
+    impulse("Svf", [&]() {
+        svf.reset();
+    }, [&](float x) {
+        svf.process(x);
+        keep(svf.lowpass);
+    });
+
+    // The modules with every feedback path turned up
+    Module::ProcessArgs args = processArgs();
+    Module::SampleRateChangeEvent e = sampleRateChange();
+
+    DiffusaireModule* diffusaire = nullptr;
+    impulse("DiffusaireModule", [&]() {
+        delete diffusaire;
+        diffusaire = new DiffusaireModule;
+        patch(diffusaire->inputs[DiffusaireModule::AUDIO_INPUT]);
+        patch(diffusaire->outputs[DiffusaireModule::AUDIO_OUTPUT]);
+        diffusaire->onSampleRateChange(e);
+        diffusaire->params[DiffusaireModule::RESONANCE_PARAM].setValue(0.9f);
+        diffusaire->params[DiffusaireModule::ECART_PARAM].setValue(0.8f);
+        diffusaire->params[DiffusaireModule::CINETIQUES_PARAM].setValue(0.5f);
+        requirePatched(diffusaire->inputs[DiffusaireModule::AUDIO_INPUT], "Diffusaire audio input");
+        requirePatched(diffusaire->outputs[DiffusaireModule::AUDIO_OUTPUT], "Diffusaire audio output");
+    }, [&](float x) {
+        diffusaire->inputs[DiffusaireModule::AUDIO_INPUT].setVoltage(5.f * x);
+        diffusaire->process(args);
+    });
+    delete diffusaire;
+
+    DubBoiteModule* dubBoite = nullptr;
+    impulse("DubBoiteModule", [&]() {
+        delete dubBoite;
+        dubBoite = new DubBoiteModule;
+        for (int i = 0; i < 4; i++) {
+            patch(dubBoite->inputs[DubBoiteModule::CH1_INPUT + i]);
+        }
+        patch(dubBoite->outputs[DubBoiteModule::MIX_OUTPUT]);
+        patch(dubBoite->outputs[DubBoiteModule::SEND_OUTPUT]);
+        dubBoite->onSampleRateChange(e);
+        dubBoite->params[DubBoiteModule::DIFFUSION_KNOB].setValue(0.8f);
+        dubBoite->params[DubBoiteModule::SCRUB_KNOB].setValue(0.5f);
+        dubBoite->params[DubBoiteModule::LOWDRIFT_KNOB].setValue(0.5f);
+        for (int i = 0; i < 4; i++) {
+            requirePatched(dubBoite->inputs[DubBoiteModule::CH1_INPUT + i], "DubBoite channel input");
+        }
+        requirePatched(dubBoite->outputs[DubBoiteModule::MIX_OUTPUT], "DubBoite mix output");
+    }, [&](float x) {
+        for (int i = 0; i < 4; i++) {
+            dubBoite->inputs[DubBoiteModule::CH1_INPUT + i].setVoltage(5.f * x);
+        }
+        dubBoite->process(args);
+    });
+    delete dubBoite;
+}
+
+} // namespace bench
@@ -0,0 +1,121 @@
+#include "bench.hpp"
+#include "mpdsp/FastMath.hpp"
+
+// Accuracy and cost of the mpdsp/FastMath.hpp approximations against the
+// standard library, over the ranges the modules feed them. Errors are
+// against a double reference; times are per value, so a float_4 call counts
+// four
+
+namespace bench {
+
+namespace {
+
+const int POINTS = 1 << 20;
+
+struct Range {
+    float lo;
+    float hi;
+
+    float at(int i) const {
+        return lo + (hi - lo) * (float)i / (float)(POINTS - 1);
+    }
+};
+
+template <typename Approx, typename Exact, typename Reference>
+void compare(const char* name, Range range, bool relative, Approx approx, Exact exact, Reference reference) {
+    ErrorStats scalar;
+    ErrorStats vector;
+    for (int i = 0; i < POINTS; i += 4) {
+        simd::float_4 x(range.at(i), range.at(i + 1), range.at(i + 2), range.at(i + 3));
+        simd::float_4 y = approx(x);
+        for (int lane = 0; lane < 4; lane++) {
+            double expected = reference((double)x[lane]);
+            scalar.add(approx(x[lane]), expected);
+            vector.add(y[lane], expected);
+        }
+    }
+    double error = relative ? std::max(scalar.maxRel, vector.maxRel) : std::max(scalar.maxAbs, vector.maxAbs);
+
+    double approxNs = nsPerCall(POINTS, [&](int i) {
+        float y = approx(range.at(i));
+        keep(y);
+    });
+    double exactNs = nsPerCall(POINTS, [&](int i) {
+        float y = exact(range.at(i));
+        keep(y);
+    });
+    double approx4Ns = nsPerCall(POINTS / 4, [&](int i) {
+        simd::float_4 x(range.at(4 * i), range.at(4 * i + 1), range.at(4 * i + 2), range.at(4 * i + 3));
+        simd::float_4 y = approx(x);
+        keep(y);
+    }) / 4.0;
+    double exact4Ns = nsPerCall(POINTS / 4, [&](int i) {
+        simd::float_4 x(range.at(4 * i), range.at(4 * i + 1), range.at(4 * i + 2), range.at(4 * i + 3));
+        simd::float_4 y;
+        for (int lane = 0; lane < 4; lane++) {
+            y[lane] = exact(x[lane]);
+        }
+        keep(y);
+    }) / 4.0;
+
+    std::printf("  %-22s %6g..%-6g %s error %.2e   float %6.2f vs %6.2f   float_4 %6.2f vs %6.2f ns/value\n",
+        name, range.lo, range.hi, relative ? "rel" : "abs", error, approxNs, exactNs, approx4Ns, exact4Ns);
+}
+
+// The approximations take float and float_4 alike, which a C++11 lambda
+// cannot
+struct Sin2pi {
+    template <typename T>
+    T operator()(T x) const {
+        return mpdsp::sin2pi(x);
+    }
+};
+
+struct Sin2piFast {
+    template <typename T>
+    T operator()(T x) const {
+        return mpdsp::sin2piFast(x);
+    }
+};
+
+struct Exp2 {
+    template <typename T>
+    T operator()(T x) const {
+        return mpdsp::exp2(x);
+    }
+};
+
+struct Tanh {
+    template <typename T>
+    T operator()(T x) const {
+        return mpdsp::tanh(x);
+    }
+};
+
+} // namespace
+
+void runFastMath() {
+    title("FastMath against std (error against double; ns/value, approximation vs std)");
+
+    // Phase of the LFOs and oscillators, including the wrapped-around values
+    // the morphing and feedback paths produce
+    Range phase = {-4.f, 4.f};
+    auto sinReference = [](double x) { return std::sin(2.0 * M_PI * x); };
+    auto stdSin = [](float x) { return std::sin(2.f * float(M_PI) * x); };
+    compare("sin2pi", phase, false, Sin2pi(), stdSin, sinReference);
+    compare("sin2piFast", phase, false, Sin2piFast(), stdSin, sinReference);
+
+    // Pitch in octaves: a V/oct input plus the knob offsets
+    Range octaves = {-10.f, 10.f};
+    compare("exp2", octaves, true, Exp2(),
+        [](float x) { return std::exp2(x); },
+        [](double x) { return std::exp2(x); });
+
+    // Saturator drive times a 10 Vpp signal scaled to +/-1
+    Range drive = {-12.f, 12.f};
+    compare("tanh", drive, false, Tanh(),
+        [](float x) { return std::tanh(x); },
+        [](double x) { return std::tanh(x); });
+}
+
+} // namespace bench
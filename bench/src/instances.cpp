@@ -0,0 +1,98 @@
+#include "bench.hpp"
+#include <thread>
+#include <vector>
+#include "../../DubBoite/src/DubBoiteModule.hpp"
+#include "../../Temporaliste/src/TemporalisteModule.hpp"
+
+// Many copies of a module stepped the way Rack's engine steps them, every
+// module once per sample. Per-sample cost that climbs with the instance
+// count means the working set has outgrown the caches; hardware counters
+// are not portable across Rack's platforms, so this only reports time
+
+namespace bench {
+
+namespace {
+
+const int COUNTS[] = {1, 4, 16, 64};
+const int SAMPLES = 1 << 14;
+
+template <typename TModule, typename S, typename D>
+void instances(const char* name, S setup, D drive) {
+    Module::ProcessArgs args = processArgs();
+    for (int count : COUNTS) {
+        std::vector<TModule*> modules;
+        for (int m = 0; m < count; m++) {
+            TModule* module = new TModule;
+            module->onSampleRateChange(sampleRateChange());
+            setup(module);
+            modules.push_back(module);
+        }
+        // Lets the buffer pool's worker hand out the delay memory the
+        // modules ask for once they start running
+        for (int round = 0; round < 20; round++) {
+            for (int i = 0; i < 480; i++) {
+                for (TModule* module : modules) {
+                    drive(module, i);
+                    module->process(args);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        double ns = nsPerCall(SAMPLES, [&](int i) {
+            for (TModule* module : modules) {
+                drive(module, i);
+                module->process(args);
+            }
+        }) / count;
+        std::printf("  %-18s x%-3d  %8.2f ns per module-sample  %6.2f%% of a core at 48 kHz\n",
+            name, count, ns, 100.0 * ns * count * SAMPLE_RATE * 1e-9);
+
+        for (TModule* module : modules) {
+            delete module;
+        }
+    }
+}
+
+} // namespace
+
+void runInstances() {
+    title("Many instances (per module and sample, all modules stepped each sample)");
+    std::printf("  DubBoiteModule %d bytes, TemporalisteModule %d bytes without delay memory\n",
+        (int)sizeof(DubBoiteModule), (int)sizeof(TemporalisteModule));
+
+    const Noise noise;
+
+    // All four channels in, with the delay-based effects turned up so every
+    // instance takes its delay memory
+    instances<DubBoiteModule>("DubBoiteModule", [](DubBoiteModule* module) {
+        for (int c = 0; c < 4; c++) {
+            patch(module->inputs[DubBoiteModule::CH1_INPUT + c]);
+            requirePatched(module->inputs[DubBoiteModule::CH1_INPUT + c], "DubBoite channel input");
+        }
+        patch(module->outputs[DubBoiteModule::MIX_OUTPUT]);
+        patch(module->outputs[DubBoiteModule::SEND_OUTPUT]);
+        requirePatched(module->outputs[DubBoiteModule::MIX_OUTPUT], "DubBoite mix output");
+        module->params[DubBoiteModule::DIFFUSION_KNOB].setValue(0.6f);
+        module->params[DubBoiteModule::SCRUB_KNOB].setValue(0.5f);
+    }, [&](DubBoiteModule* module, int i) {
+        for (int c = 0; c < 4; c++) {
+            module->inputs[DubBoiteModule::CH1_INPUT + c].setVoltage(5.f * noise.at(i + 1024 * c));
+        }
+    });
+
+    // An 8 Hz clock into every instance and every output patched; the CV
+    // inputs stay unpatched
+    instances<TemporalisteModule>("TemporalisteModule", [](TemporalisteModule* module) {
+        patch(module->inputs[TemporalisteModule::CLOCK_INPUT]);
+        requirePatched(module->inputs[TemporalisteModule::CLOCK_INPUT], "Temporaliste clock input");
+        for (Output& output : module->outputs) {
+            patch(output);
+        }
+        module->params[TemporalisteModule::DENSITY_PARAM].setValue(0.8f);
+    }, [](TemporalisteModule* module, int i) {
+        module->inputs[TemporalisteModule::CLOCK_INPUT].setVoltage((i % 6000) < 3000 ? 10.f : 0.f);
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include <cstring>
+
+namespace {
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+const Suite suites[] = {
+    {"primitives", bench::runPrimitives},
+    {"fastmath", bench::runFastMath},
+    {"denormal", bench::runDenormal},
+    {"instances", bench::runInstances},
+};
+
+} // namespace
+
+// Runs the suites named on the command line, or all of them
+int main(int argc, char** argv) {
+    bool ran = false;
+    for (const Suite& suite : suites) {
+        bool wanted = (argc < 2);
+        for (int i = 1; i < argc; i++) {
+            wanted = wanted || std::strcmp(argv[i], suite.name) == 0;
+        }
+        if (wanted) {
+            suite.run();
+            ran = true;
+        }
+    }
+    if (!ran) {
+        std::fprintf(stderr, "Suites:");
+        for (const Suite& suite : suites) {
+            std::fprintf(stderr, " %s", suite.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
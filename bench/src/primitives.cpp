@@ -0,0 +1,115 @@
+#include "bench.hpp"
+#include "mpdsp/AllPass.hpp"
+#include "mpdsp/DelayLine.hpp"
+#include "mpdsp/Phasor.hpp"
+#include "mpdsp/Smoother.hpp"
+#include "mpdsp/Svf.hpp"
+#include "mpdsp/TableOscillator.hpp"
+
+// Per-sample cost of the shared building blocks, once for a single voice
+// and once for four voices in a float_4
+
+namespace bench {
+
+namespace {
+
+const int CALLS = 1 << 20;
+const Noise noise;
+
+template <typename T>
+T input(int i);
+
+template <>
+float input<float>(int i) {
+    return noise.at(i);
+}
+
+template <>
+simd::float_4 input<simd::float_4>(int i) {
+    return noise.at4(i);
+}
+
+template <typename T>
+void runVoices(const char* voices) {
+    char name[64];
+
+    mpdsp::DelayLine<T> delay;
+    delay.resize(4096);
+    std::snprintf(name, sizeof(name), "DelayLine push + readLinear (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        delay.push(input<T>(i));
+        T out = delay.readLinear(1000.f + 500.f * noise.at(i >> 6));
+        keep(out);
+    }), "sample");
+    std::snprintf(name, sizeof(name), "DelayLine push + readCubic (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        delay.push(input<T>(i));
+        T out = delay.readCubic(1000.f + 500.f * noise.at(i >> 6));
+        keep(out);
+    }), "sample");
+
+    mpdsp::Phasor<T> phasor;
+    std::snprintf(name, sizeof(name), "Phasor (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        T out = phasor.process(0.01f + 0.001f * input<T>(i));
+        keep(out);
+    }), "sample");
+
+    mpdsp::Svf<T> svf;
+    svf.setCutoff(0.05f, 2.f);
+    std::snprintf(name, sizeof(name), "Svf (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        svf.process(input<T>(i));
+        keep(svf.lowpass);
+    }), "sample");
+    std::snprintf(name, sizeof(name), "Svf, cutoff set every sample (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        svf.setCutoff(0.05f + 0.02f * input<T>(i >> 4), 2.f);
+        svf.process(input<T>(i));
+        keep(svf.lowpass);
+    }), "sample");
+
+    mpdsp::AllPass1<T> allPass;
+    std::snprintf(name, sizeof(name), "AllPass1 (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        T out = allPass.process(input<T>(i), 0.6f);
+        keep(out);
+    }), "sample");
+
+    mpdsp::Smoother<T> smoother;
+    smoother.setTime(0.01f, 1.f / 48000.f);
+    std::snprintf(name, sizeof(name), "Smoother (%s)", voices);
+    line(name, nsPerCall(CALLS, [&](int i) {
+        T out = smoother.process(input<T>(i >> 8));
+        keep(out);
+    }), "sample");
+}
+
+} // namespace
+
+void runPrimitives() {
+    title("Primitives, one voice");
+    runVoices<float>("float");
+
+    mpdsp::TableOscillator<2048> oscillator;
+    for (int i = 0; i < 2048; i++) {
+        oscillator.table[i] = std::sin(2.f * float(M_PI) * i / 2048.f);
+    }
+    line("TableOscillator<2048> (float)", nsPerCall(CALLS, [&](int i) {
+        float out = oscillator.process(0.01f + 0.001f * noise.at(i));
+        keep(out);
+    }), "sample");
+
+    title("Primitives, four voices");
+    runVoices<simd::float_4>("float_4");
+
+    simd::float_4 phase = 0.f;
+    line("readTable<2048> (float_4)", nsPerCall(CALLS, [&](int i) {
+        phase += 0.01f + 0.001f * noise.at4(i);
+        phase -= simd::floor(phase);
+        simd::float_4 out = mpdsp::readTable<2048>(oscillator.table, phase);
+        keep(out);
+    }), "sample");
+}
+
+} // namespace bench
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include "Common.hpp"
+
+namespace mpdsp {
+
+static const size_t CACHE_LINE = 64;
+
+// malloc() only promises 16 bytes and aligned_alloc() is missing on some of
+// Rack's platforms, so over-allocate and keep the original pointer just
+// in front of the aligned block
+inline void* alignedAlloc(size_t size, size_t align = CACHE_LINE) {
+    // At least a pointer, so a free block can hold a list link
+    size = std::max(size, sizeof(void*));
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw) throw std::bad_alloc();
+    uintptr_t start = (uintptr_t)raw + sizeof(void*);
+    void* aligned = (void*)((start + align - 1) & ~(uintptr_t)(align - 1));
+    ((void**)aligned)[-1] = raw;
+    return aligned;
+}
+
+inline void alignedFree(void* p) {
+    if (p) std::free(((void**)p)[-1]);
+}
+
+// Base for modules that put their per-sample state in an
+// alignas(CACHE_LINE) block. Before C++17 plain new ignores over-alignment,
+// so the module brings its own. Rack deletes modules through Module*, which
+// still finds this operator delete through the virtual destructor
+struct CacheAligned {
+    static void* operator new(size_t size) {
+        return alignedAlloc(size);
+    }
+
+    static void operator delete(void* p) {
+        alignedFree(p);
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,24 @@
+#pragma once
+#include "Common.hpp"
+#include "Denormal.hpp"
+
+namespace mpdsp {
+
+// First-order allpass, y = -c*x + x[n-1] + c*y[n-1] in transposed form.
+// Coefficient in -1..1 sets where the phase crosses -90 degrees
+template <typename T = float>
+struct AllPass1 {
+    T state = 0.f;
+
+    MPDSP_INLINE T process(T x, T coeff) {
+        T y = -coeff * x + state;
+        state = flushDenormal(x + coeff * y);
+        return y;
+    }
+
+    void reset() {
+        state = 0.f;
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,206 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include "Aligned.hpp"
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Zeroed, cache-aligned memory blocks for stages that only take their delay
+// memory once they are first switched on. Blocks come in power-of-two byte
+// sizes. The audio thread takes them with acquire(), which is lock-free and
+// never allocates: it either pops a ready block or notes the shortfall and
+// returns nullptr, and the stage stays bypassed until a later try succeeds.
+// A worker thread wakes every few milliseconds, with or without a GUI, to
+// free retired blocks and run refill(), which tops every size class in use
+// back up to a couple of spare blocks plus whatever was asked for since, up
+// to CAPACITY per call. One pool serves every module in the plugin
+struct BufferPool {
+    static const int MIN_CLASS = 10; // 1 KB
+    static const int NUM_CLASSES = 16; // Up to 32 MB
+    static const int CAPACITY = 64;
+    static const int SPARE = 2;
+    static const int WORKER_PERIOD_MS = 10;
+
+    struct SizeClass {
+        std::atomic<void*> ready[CAPACITY];
+        std::atomic<int> shortfall;
+        std::atomic<bool> used;
+    };
+    SizeClass classes[NUM_CLASSES];
+    std::atomic<bool> pending;
+    std::mutex refillMutex;
+    // Blocks handed back from the audio thread, as a list linked through
+    // their first word
+    std::atomic<void*> retired;
+
+    std::thread worker;
+    std::mutex workerMutex;
+    std::condition_variable workerWake;
+    bool stopping = false;
+    std::atomic<bool> workerDone;
+
+    BufferPool() {
+        for (int c = 0; c < NUM_CLASSES; c++) {
+            for (int i = 0; i < CAPACITY; i++) {
+                classes[c].ready[i].store(nullptr);
+            }
+            classes[c].shortfall.store(0);
+            classes[c].used.store(false);
+        }
+        pending.store(false);
+        retired.store(nullptr);
+        workerDone.store(false);
+        worker = std::thread([this]() { run(); });
+    }
+
+    ~BufferPool() {
+        {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            stopping = true;
+        }
+        workerWake.notify_one();
+#if defined ARCH_WIN
+        // This runs while the plugin DLL unloads, under the loader lock,
+        // which a joined thread needs in order to exit. Wait briefly for the
+        // worker to leave its loop instead (at process exit it is already
+        // gone)
+        for (int i = 0; i < 100 && !workerDone.load(); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        worker.detach();
+#else
+        worker.join();
+#endif
+        freeRetired();
+        for (int c = 0; c < NUM_CLASSES; c++) {
+            for (int i = 0; i < CAPACITY; i++) {
+                alignedFree(classes[c].ready[i].load());
+            }
+        }
+    }
+
+    void run() {
+        // A copy, as chrono takes the period by reference
+        int periodMs = WORKER_PERIOD_MS;
+        std::unique_lock<std::mutex> lock(workerMutex);
+        while (!stopping) {
+            workerWake.wait_for(lock, std::chrono::milliseconds(periodMs));
+            lock.unlock();
+            freeRetired();
+            refill();
+            lock.lock();
+        }
+        workerDone.store(true);
+    }
+
+    // Size class holding blocks of at least `bytes`
+    static int classOf(size_t bytes) {
+        int c = 0;
+        while (((size_t)1 << (MIN_CLASS + c)) < bytes && c < NUM_CLASSES - 1) c++;
+        return c;
+    }
+
+    static size_t classBytes(int c) {
+        return (size_t)1 << (MIN_CLASS + c);
+    }
+
+    // Audio thread: declares that blocks of this size will be asked for; the
+    // worker readies some shortly
+    void use(size_t bytes) {
+        SizeClass& sizeClass = classes[classOf(bytes)];
+        if (!sizeClass.used.load(std::memory_order_relaxed)) {
+            sizeClass.used.store(true, std::memory_order_relaxed);
+            pending.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Off the audio thread: like use(), but makes sure a block is ready right
+    // away, so the first stage to switch on does not have to wait
+    void reserve(size_t bytes) {
+        SizeClass& sizeClass = classes[classOf(bytes)];
+        if (!sizeClass.used.exchange(true)) {
+            pending.store(true);
+            refill();
+        }
+    }
+
+    // Audio thread. A caller that keeps retrying should only count its
+    // shortfall once
+    void* acquire(size_t bytes, bool countShortfall = true) {
+        SizeClass& sizeClass = classes[classOf(bytes)];
+        for (int i = 0; i < CAPACITY; i++) {
+            void* block = sizeClass.ready[i].load(std::memory_order_relaxed);
+            if (block && sizeClass.ready[i].compare_exchange_strong(block, nullptr, std::memory_order_acquire)) {
+                pending.store(true, std::memory_order_relaxed);
+                return block;
+            }
+        }
+        if (countShortfall) {
+            sizeClass.shortfall.fetch_add(1, std::memory_order_relaxed);
+            sizeClass.used.store(true, std::memory_order_relaxed);
+            pending.store(true, std::memory_order_relaxed);
+        }
+        return nullptr;
+    }
+
+    // Audio thread: hands a block back for the worker to free
+    void retire(void* block) {
+        if (!block) return;
+        void* next = retired.load(std::memory_order_relaxed);
+        do {
+            *(void**)block = next;
+        } while (!retired.compare_exchange_weak(next, block, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Off the audio thread
+    void freeRetired() {
+        void* block = retired.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            void* next = *(void**)block;
+            alignedFree(block);
+            block = next;
+        }
+    }
+
+    // Off the audio thread
+    void refill() {
+        if (!pending.exchange(false)) return;
+        std::lock_guard<std::mutex> lock(refillMutex);
+        for (int c = 0; c < NUM_CLASSES; c++) {
+            SizeClass& sizeClass = classes[c];
+            if (!sizeClass.used.load()) continue;
+            // Whatever does not fit this time is handed out on the next call
+            int target = SPARE + sizeClass.shortfall.exchange(0);
+            if (target > CAPACITY) {
+                sizeClass.shortfall.fetch_add(target - CAPACITY);
+                pending.store(true);
+                target = CAPACITY;
+            }
+            int ready = 0;
+            for (int i = 0; i < CAPACITY; i++) {
+                ready += sizeClass.ready[i].load() != nullptr;
+            }
+            for (int i = 0; i < CAPACITY && ready < target; i++) {
+                if (sizeClass.ready[i].load()) continue;
+                void* block = alignedAlloc(classBytes(c));
+                std::memset(block, 0, classBytes(c));
+                // Slots are only filled under the lock, so an empty slot
+                // stays empty until this store
+                sizeClass.ready[i].store(block, std::memory_order_release);
+                ready++;
+            }
+        }
+    }
+};
+
+inline BufferPool& bufferPool() {
+    static BufferPool pool;
+    return pool;
+}
+
+} // namespace mpdsp
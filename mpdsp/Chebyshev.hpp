@@ -0,0 +1,22 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Chebyshev polynomial of the first kind, T_n(x), by the three-term
+// recurrence. For |x| <= 1, T_n(cos a) = cos(n*a): feeding a sine in gives
+// its nth harmonic
+template <typename T>
+MPDSP_INLINE T chebyshev(int n, T x) {
+    if (n <= 0) return T(1.f);
+    T prev = 1.f;
+    T curr = x;
+    for (int i = 1; i < n; i++) {
+        T next = 2.f * x * curr - prev;
+        prev = curr;
+        curr = next;
+    }
+    return curr;
+}
+
+} // namespace mpdsp
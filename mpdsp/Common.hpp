@@ -0,0 +1,23 @@
+#pragma once
+#include <rack.hpp>
+
+// Shared DSP building blocks for the MaxPa plugins. Everything here is
+// header-only and templated on the sample type, so the same code runs on
+// float and on rack::simd::float_4 (four voices or four lanes per call)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MPDSP_INLINE __attribute__((always_inline)) inline
+#else
+#define MPDSP_INLINE inline
+#endif
+
+namespace mpdsp {
+
+// Power of two at or above n (n >= 1)
+inline int nextPow2(int n) {
+    int size = 1;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+} // namespace mpdsp
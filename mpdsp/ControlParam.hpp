@@ -0,0 +1,154 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Samples between knob reads unless a module picks its own. Modules drive
+// this with a dsp::ClockDivider
+static const int CONTROL_BLOCK_SIZE = 32;
+
+// Knob plus attenuated CV, scaled like cvParam(), for modules that run
+// derived math on the result. The knob and attenuverter are read once per
+// control block and the knob ramps linearly to its new position over the
+// block, so a turned knob never steps. A patched CV is still read every
+// sample; an unpatched one is not read at all. changed() tells whether the
+// value moved this sample, which suits cheap lookups. Costly derived
+// coefficients go by target() instead: the value the knob ramps to plus the
+// CV as read at the block start. targetChanged() is only ever true on the
+// first sample of a block, so they are worked out once per block and ramped
+// over it with a CoeffRamp
+struct ControlParam {
+    int paramId = 0;
+    int inputId = 0;
+    int attenId = 0;
+    float minValue = 0.f;
+    float maxValue = 1.f;
+
+    float knob = 0.f;
+    float knobTarget = 0.f;
+    float knobStep = 0.f;
+    float atten = 0.f;
+    bool cvConnected = false;
+
+    float value = 0.f;
+    bool moved = true;
+    bool primed = false;
+
+    float blockTarget = 0.f;
+    bool retargeted = true;
+    bool restarted = true;
+
+    void config(int paramId, int inputId, int attenId, float minValue = 0.f, float maxValue = 1.f) {
+        this->paramId = paramId;
+        this->inputId = inputId;
+        this->attenId = attenId;
+        this->minValue = minValue;
+        this->maxValue = maxValue;
+    }
+
+    // Jump straight to the knob on the next process() and report a change,
+    // e.g. after the derived state was rebuilt for a new sample rate. The
+    // next block is flagged as restarted, so coefficient ramps jump too
+    void reset() {
+        primed = false;
+    }
+
+    MPDSP_INLINE float process(rack::engine::Module* module, bool blockStart, int blockSize = CONTROL_BLOCK_SIZE) {
+        bool newBlock = blockStart || !primed;
+        if (newBlock) {
+            knobTarget = module->params[paramId].getValue();
+            atten = module->params[attenId].getValue();
+            cvConnected = module->inputs[inputId].isConnected();
+            if (!primed) knob = knobTarget;
+            knobStep = (knobTarget - knob) / (float)blockSize;
+        }
+        if (knobStep != 0.f) {
+            knob += knobStep;
+            if ((knobStep > 0.f) == (knob >= knobTarget)) {
+                knob = knobTarget;
+                knobStep = 0.f;
+            }
+        }
+
+        float cv = 0.f;
+        if (cvConnected) {
+            cv = module->inputs[inputId].getVoltage() * atten * 0.1f;
+        }
+        float v = rack::math::clamp(knob + cv, minValue, maxValue);
+        moved = (v != value) || !primed;
+        if (newBlock) {
+            float t = rack::math::clamp(knobTarget + cv, minValue, maxValue);
+            retargeted = (t != blockTarget) || !primed;
+            restarted = !primed;
+            blockTarget = t;
+        }
+        else {
+            retargeted = false;
+        }
+        primed = true;
+        value = v;
+        return v;
+    }
+
+    bool changed() const {
+        return moved;
+    }
+
+    float target() const {
+        return blockTarget;
+    }
+
+    bool targetChanged() const {
+        return retargeted;
+    }
+
+    // True for the first block after config or reset(), when there is
+    // nothing sensible to ramp from
+    bool restartedBlock() const {
+        return restarted;
+    }
+};
+
+// Derived coefficients ramped linearly from their last values to new targets
+// over one control block, so they can be worked out at control rate without
+// stepping. Read value[]; call process() once per sample
+template <typename T, int N>
+struct CoeffRamp {
+    T value[N] = {};
+    T step[N] = {};
+    T target[N] = {};
+    int remaining = 0;
+
+    // Fill target[] first. jump skips the ramp, e.g. for the first block
+    void start(int blockSize, bool jump) {
+        if (jump || blockSize <= 1) {
+            for (int i = 0; i < N; i++) {
+                value[i] = target[i];
+                step[i] = 0.f;
+            }
+            remaining = 0;
+            return;
+        }
+        float scale = 1.f / (float)blockSize;
+        for (int i = 0; i < N; i++) {
+            step[i] = (target[i] - value[i]) * scale;
+        }
+        remaining = blockSize;
+    }
+
+    MPDSP_INLINE void process() {
+        if (remaining == 0) return;
+        if (--remaining == 0) {
+            // Land exactly, whatever rounding built up on the way
+            for (int i = 0; i < N; i++) {
+                value[i] = target[i];
+            }
+            return;
+        }
+        for (int i = 0; i < N; i++) {
+            value[i] += step[i];
+        }
+    }
+};
+
+} // namespace mpdsp
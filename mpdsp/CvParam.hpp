@@ -0,0 +1,14 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Knob plus attenuated CV, the way every panel here wires it: +/-10V at full
+// attenuverter sweeps the whole 0..1 knob range. Unpatched inputs read 0V
+inline float cvParam(rack::engine::Module* module, int paramId, int inputId, int attenId, float minValue = 0.f, float maxValue = 1.f) {
+    float value = module->params[paramId].getValue();
+    value += module->inputs[inputId].getVoltage() * module->params[attenId].getValue() * 0.1f;
+    return rack::math::clamp(value, minValue, maxValue);
+}
+
+} // namespace mpdsp
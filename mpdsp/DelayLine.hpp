@@ -0,0 +1,131 @@
+#pragma once
+#include <cstring>
+#include "Aligned.hpp"
+#include "BufferPool.hpp"
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Circular delay line with a power-of-two buffer, so wrapping is a mask
+// instead of a modulo. Call push() once per sample, then read back: delay 0
+// is the sample just pushed. The buffer is allocated on its own, starting on
+// a cache line, so only the write position and mask sit in the owner.
+// resize() allocates straight away. A line sized with reserve() or
+// requestSize() has no memory until acquire() takes a zeroed block from the
+// buffer pool; stages that may never be switched on use that so loading a
+// patch does not touch their memory
+template <typename T = float>
+struct DelayLine {
+    T* buffer = nullptr;
+    int mask = 0;
+    int writePos = 0;
+    bool requested = false;
+
+    // No memory until resize(), reserve() or requestSize()
+    DelayLine() {}
+
+    ~DelayLine() {
+        release();
+    }
+
+    DelayLine(const DelayLine&) = delete;
+    DelayLine& operator=(const DelayLine&) = delete;
+
+    // Rounds up to a power of two and clears the contents
+    void resize(int minSize) {
+        setSize(minSize);
+        buffer = (T*)alignedAlloc(bytes());
+        clear();
+    }
+
+    // Like resize(), but leaves the line without memory until acquire()
+    void reserve(int minSize) {
+        setSize(minSize);
+        bufferPool().reserve(bytes());
+    }
+
+    // Like reserve(), but safe on the audio thread, e.g. from
+    // onSampleRateChange(). A line that already has the size keeps its
+    // memory; otherwise the memory goes back to the pool to be freed there
+    // and acquire() takes a block of the new size
+    void requestSize(int minSize) {
+        int newMask = nextPow2(std::max(minSize, 1)) - 1;
+        if (newMask == mask) return;
+        bufferPool().retire(buffer);
+        buffer = nullptr;
+        requested = false;
+        mask = newMask;
+        writePos = 0;
+        bufferPool().use(bytes());
+    }
+
+    // Audio thread: true once the line has its memory. Until then the
+    // caller should bypass whatever the line is part of and try again on a
+    // later sample
+    MPDSP_INLINE bool acquire() {
+        if (buffer) return true;
+        buffer = (T*)bufferPool().acquire(bytes(), !requested);
+        requested = !buffer;
+        return buffer != nullptr;
+    }
+
+    // Hands the memory back; off the audio thread
+    void release() {
+        alignedFree(buffer);
+        buffer = nullptr;
+        requested = false;
+    }
+
+    void clear() {
+        if (buffer) std::memset(buffer, 0, bytes());
+    }
+
+    int size() const {
+        return mask + 1;
+    }
+
+    size_t bytes() const {
+        return (size_t)size() * sizeof(T);
+    }
+
+    void setSize(int minSize) {
+        release();
+        mask = nextPow2(std::max(minSize, 1)) - 1;
+        writePos = 0;
+    }
+
+    MPDSP_INLINE void push(T x) {
+        writePos = (writePos + 1) & mask;
+        buffer[writePos] = x;
+    }
+
+    MPDSP_INLINE T read(int delay) const {
+        return buffer[(writePos - delay) & mask];
+    }
+
+    // Fractional delay, 0 <= delay <= size() - 2
+    MPDSP_INLINE T readLinear(float delay) const {
+        int d = (int)delay;
+        float frac = delay - (float)d;
+        T a = read(d);
+        T b = read(d + 1);
+        return a + (b - a) * frac;
+    }
+
+    // Catmull-Rom between the two taps around the delay. Needs one newer
+    // sample, so 1 <= delay <= size() - 3
+    MPDSP_INLINE T readCubic(float delay) const {
+        int d = (int)delay;
+        float frac = delay - (float)d;
+        T x0 = read(d - 1);
+        T x1 = read(d);
+        T x2 = read(d + 1);
+        T x3 = read(d + 2);
+        T c1 = 0.5f * (x2 - x0);
+        T c2 = x0 - 2.5f * x1 + 2.f * x2 - 0.5f * x3;
+        T c3 = 0.5f * (x3 - x0) + 1.5f * (x1 - x2);
+        return ((c3 * frac + c2) * frac + c1) * frac + x1;
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,16 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Recursive states that decay towards zero end up in the subnormal range,
+// where x86 arithmetic slows down by orders of magnitude. Flush-to-zero is a
+// property of whichever thread runs the module, so rather than rely on it
+// every feedback state is passed through this on its way back in. 1e-30 is
+// 600 dB below a 10V signal
+template <typename T>
+MPDSP_INLINE T flushDenormal(T x) {
+    return rack::simd::ifelse(rack::simd::fabs(x) < 1e-30f, T(0.f), x);
+}
+
+} // namespace mpdsp
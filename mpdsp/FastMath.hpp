@@ -0,0 +1,77 @@
+#pragma once
+#include "Common.hpp"
+
+// Branch-free approximations of the transcendental functions the modules use
+// per sample. Each one is templated so the same code serves float and
+// simd::float_4; the errors below are measured over the whole float range
+namespace mpdsp {
+
+// sin(2*pi*phase) for any phase: reduced to a quarter cycle, then a 9th-order
+// Taylor polynomial (error below 4e-6)
+template <typename T>
+MPDSP_INLINE T sin2pi(T phase) {
+    T x = phase - rack::simd::floor(phase + 0.5f); // -0.5..0.5
+    T a = rack::simd::fabs(x);
+    T z = 2.f * float(M_PI) * rack::simd::fmin(a, 0.5f - a); // 0..pi/2
+    T z2 = z * z;
+    T s = z * (1.f + z2 * (-1.f / 6.f + z2 * (1.f / 120.f + z2 * (-1.f / 5040.f + z2 * (1.f / 362880.f)))));
+    return rack::simd::ifelse(x < 0.f, -s, s);
+}
+
+// Cheaper sin(2*pi*phase) from a corrected parabola, max error about 0.001.
+// Good enough for modulation sources
+template <typename T>
+MPDSP_INLINE T sin2piFast(T phase) {
+    T x = phase - rack::simd::floor(phase + 0.5f); // -0.5..0.5
+    T y = 8.f * x - 16.f * x * rack::simd::fabs(x);
+    return y + 0.225f * (y * rack::simd::fabs(y) - y);
+}
+
+// m * 2^n for whole-valued n in -126..127, written straight into the exponent
+MPDSP_INLINE float scalePow2(float m, float n) {
+    union {
+        uint32_t bits;
+        float value;
+    } scale;
+    scale.bits = (uint32_t)((int)n + 127) << 23;
+    return m * scale.value;
+}
+
+MPDSP_INLINE rack::simd::float_4 scalePow2(rack::simd::float_4 m, rack::simd::float_4 n) {
+    rack::simd::int32_4 bits = (rack::simd::int32_4(n) + rack::simd::int32_4(127)) << 23;
+    return m * rack::simd::float_4::cast(bits);
+}
+
+// 2^x, relative error below 1e-6 (a five-hundredth of a cent). The fraction
+// goes through a degree-5 minimax polynomial, the whole part through
+// scalePow2(). Results saturate at 2^-126 and 2^127
+template <typename T>
+MPDSP_INLINE T exp2(T x) {
+    x = rack::simd::fmin(rack::simd::fmax(x, -126.f), 127.f);
+    T whole = rack::simd::floor(x);
+    T f = x - whole;
+    T p = 1.f + f * (0.69315308f + f * (0.24015361f + f * (0.055826318f + f * (0.0089893397f + f * 0.0018775767f))));
+    return scalePow2(p, whole);
+}
+
+// tanh(x), absolute error below 4e-7. Odd 13th over even 6th order rational
+// fit; beyond +/-7.9 the float result is 1 anyway
+template <typename T>
+MPDSP_INLINE T tanh(T x) {
+    x = rack::simd::fmin(rack::simd::fmax(x, -7.9053111f), 7.9053111f);
+    T x2 = x * x;
+    T p = -2.76076847742355e-16f;
+    p = p * x2 + 2.00018790482477e-13f;
+    p = p * x2 - 8.60467152213735e-11f;
+    p = p * x2 + 5.12229709037114e-08f;
+    p = p * x2 + 1.48572235717979e-05f;
+    p = p * x2 + 6.37261928875436e-04f;
+    p = p * x2 + 4.89352455891786e-03f;
+    T q = 1.19825839466702e-06f;
+    q = q * x2 + 1.18534705686654e-04f;
+    q = q * x2 + 2.26843463243900e-03f;
+    q = q * x2 + 4.89352518554385e-03f;
+    return x * p / q;
+}
+
+} // namespace mpdsp
@@ -0,0 +1,46 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Lets an effect sleep through silence. The effect reports the loudest of
+// its input and output (plus any feedback it keeps) every processed sample;
+// once all of them have stayed under the threshold for longer than the tail,
+// whatever is left in its buffers and filters is below it too, so the
+// effect can skip its work and output 0V. A single loud input sample wakes
+// it, on that same sample
+struct IdleDetector {
+    // -120 dB below 10V
+    static constexpr float THRESHOLD = 1e-5f;
+
+    int tailSamples = 0;
+    int quietSamples = 0;
+
+    // Longest time the effect can keep sounding after its input stops,
+    // e.g. the length of its delay buffer
+    void setTail(int samples) {
+        tailSamples = samples;
+        quietSamples = 0;
+    }
+
+    // Forget the silence seen so far, e.g. after a setting change that
+    // lengthens the tail
+    void wake() {
+        quietSamples = 0;
+    }
+
+    MPDSP_INLINE bool isIdle(float input) const {
+        return quietSamples >= tailSamples && std::fabs(input) <= THRESHOLD;
+    }
+
+    MPDSP_INLINE void observe(float level) {
+        if (std::fabs(level) > THRESHOLD) {
+            quietSamples = 0;
+        }
+        else if (quietSamples < tailSamples) {
+            quietSamples++;
+        }
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,23 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Wrapping 0..1 ramp. The increment is frequency * sampleTime and may be
+// negative or larger than one
+template <typename T = float>
+struct Phasor {
+    T phase = 0.f;
+
+    MPDSP_INLINE T process(T increment) {
+        phase += increment;
+        phase -= rack::simd::floor(phase);
+        return phase;
+    }
+
+    void reset(T value = 0.f) {
+        phase = value;
+    }
+};
+
+} // namespace mpdsp
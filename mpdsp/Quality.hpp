@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// CPU/quality tiers. Each module maps a tier onto its own harmonic, grain
+// and all-pass counts, control block size and interpolation order; Normal
+// is the sound the modules had before tiers existed
+enum Quality {
+    QUALITY_ECO,
+    QUALITY_NORMAL,
+    QUALITY_HIGH,
+    NUM_QUALITIES
+};
+
+// A module's quality setting; this one follows the plugin-wide default
+static const int QUALITY_DEFAULT = -1;
+
+inline std::string defaultQualityPath() {
+    return rack::asset::user("MaxPatzelt.json");
+}
+
+inline int loadDefaultQuality() {
+    int quality = QUALITY_NORMAL;
+    json_t* rootJ = json_load_file(defaultQualityPath().c_str(), 0, NULL);
+    if (rootJ) {
+        json_t* qualityJ = json_object_get(rootJ, "defaultQuality");
+        if (qualityJ) {
+            quality = rack::math::clamp((int)json_integer_value(qualityJ), 0, NUM_QUALITIES - 1);
+        }
+        json_decref(rootJ);
+    }
+    return quality;
+}
+
+// Plugin-wide default tier, kept in the Rack user folder so one setting
+// covers every patch on a machine. Read from disk on first use, which the
+// module constructors make sure happens off the audio thread
+inline std::atomic<int>& defaultQualityStore() {
+    static std::atomic<int> quality(loadDefaultQuality());
+    return quality;
+}
+
+inline int defaultQuality() {
+    return defaultQualityStore().load(std::memory_order_relaxed);
+}
+
+// Each standalone plugin is its own library with its own copy of the
+// default, so a change made from another plugin's menu only reaches this one
+// through the file. UI thread only
+inline void reloadDefaultQuality() {
+    defaultQualityStore().store(loadDefaultQuality());
+}
+
+// reloadDefaultQuality() at most once a second, for ModuleWidget::step()
+inline void pollDefaultQuality() {
+    static double lastPoll = 0.0;
+    double now = rack::system::getTime();
+    if (now - lastPoll < 1.0) return;
+    lastPoll = now;
+    reloadDefaultQuality();
+}
+
+inline void setDefaultQuality(int quality) {
+    defaultQualityStore().store(rack::math::clamp(quality, 0, NUM_QUALITIES - 1));
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "defaultQuality", json_integer(defaultQuality()));
+    json_dump_file(rootJ, defaultQualityPath().c_str(), JSON_INDENT(2));
+    json_decref(rootJ);
+}
+
+// The tier a module setting stands for right now
+inline int resolveQuality(int setting) {
+    return (setting == QUALITY_DEFAULT) ? defaultQuality() : setting;
+}
+
+// Per-module quality choice plus the plugin-wide default, for
+// appendContextMenu()
+inline void appendQualityMenu(rack::ui::Menu* menu, int* setting) {
+    reloadDefaultQuality();
+    static const char* const NAMES[NUM_QUALITIES] = {"Eco", "Normal", "High"};
+    std::vector<std::string> labels = {std::string("Default (") + NAMES[defaultQuality()] + ")"};
+    labels.insert(labels.end(), NAMES, NAMES + NUM_QUALITIES);
+    menu->addChild(rack::createIndexSubmenuItem("Quality", labels,
+        [=]() { return (size_t)(*setting + 1); },
+        [=](size_t index) { *setting = (int)index - 1; }
+    ));
+    menu->addChild(rack::createIndexSubmenuItem("Default quality (all modules)", std::vector<std::string>(NAMES, NAMES + NUM_QUALITIES),
+        []() { return (size_t)defaultQuality(); },
+        [](size_t index) { setDefaultQuality((int)index); }
+    ));
+}
+
+} // namespace mpdsp
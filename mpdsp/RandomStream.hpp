@@ -0,0 +1,65 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Counter-based random stream (splitmix64 finalizer over seed + n * gamma).
+// Draw n depends only on the seed and n, so a seed stored in the patch replays
+// the same sequence, and uniform4() can hash four counters independently.
+struct RandomStream {
+    uint64_t seed = 0;
+    uint64_t counter = 0;
+
+    static MPDSP_INLINE uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static MPDSP_INLINE float toFloat(uint64_t bits) {
+        return (float)(bits >> 40) * (1.f / 16777216.f);
+    }
+
+    void setSeed(uint64_t s) {
+        seed = s;
+        counter = 0;
+    }
+
+    // Uniform in [0, 1)
+    MPDSP_INLINE float uniform() {
+        counter++;
+        return toFloat(mix(seed + counter * 0x9E3779B97F4A7C15ull));
+    }
+
+    // Four draws at once, the same values four uniform() calls would give
+    MPDSP_INLINE rack::simd::float_4 uniform4() {
+        rack::simd::float_4 r;
+        for (int i = 0; i < 4; i++) {
+            r[i] = toFloat(mix(seed + (counter + 1 + i) * 0x9E3779B97F4A7C15ull));
+        }
+        counter += 4;
+        return r;
+    }
+};
+
+// Saves a stream's seed together with the id of the module that owns it
+inline void seedToJson(json_t* rootJ, const RandomStream& rng, int64_t moduleId) {
+    json_object_set_new(rootJ, "seed", json_integer((json_int_t)rng.seed));
+    json_object_set_new(rootJ, "seedModuleId", json_integer((json_int_t)moduleId));
+}
+
+// Reads a seed saved by seedToJson(). It is only handed back when the JSON
+// comes from this same module (the patch being reloaded); a duplicated module
+// or a preset saved from another instance keeps the fresh seed it was built
+// with, so no two instances share a stream. Patches saved before the id was
+// stored keep their seed
+inline bool seedFromJson(json_t* rootJ, int64_t moduleId, uint64_t* seed) {
+    json_t* seedJ = json_object_get(rootJ, "seed");
+    if (!seedJ) return false;
+    json_t* moduleIdJ = json_object_get(rootJ, "seedModuleId");
+    if (moduleIdJ && (int64_t)json_integer_value(moduleIdJ) != moduleId) return false;
+    *seed = (uint64_t)json_integer_value(seedJ);
+    return true;
+}
+
+} // namespace mpdsp
@@ -0,0 +1,28 @@
+#pragma once
+#include "Common.hpp"
+#include "Denormal.hpp"
+
+namespace mpdsp {
+
+// One-pole lowpass for taking the steps out of control values.
+// setTime() takes the time constant in seconds
+template <typename T = float>
+struct Smoother {
+    T value = 0.f;
+    float coeff = 1.f;
+
+    void setTime(float seconds, float sampleTime) {
+        coeff = (seconds > 0.f) ? 1.f - std::exp(-sampleTime / seconds) : 1.f;
+    }
+
+    MPDSP_INLINE T process(T target) {
+        value = flushDenormal(value + (target - value) * coeff);
+        return value;
+    }
+
+    void reset(T v) {
+        value = v;
+    }
+};
+
+} // namespace mpdsp
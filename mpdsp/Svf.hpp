@@ -0,0 +1,49 @@
+#pragma once
+#include "Common.hpp"
+#include "Denormal.hpp"
+
+namespace mpdsp {
+
+// Trapezoidal (zero-delay feedback) state variable filter. Stable for any
+// cutoff below Nyquist and safe to modulate at audio rate. All three
+// responses come out of one process() call
+template <typename T = float>
+struct Svf {
+    T ic1 = 0.f;
+    T ic2 = 0.f;
+    T g = 0.f;
+    T k = 2.f;
+    T a1 = 1.f, a2 = 0.f, a3 = 0.f;
+
+    T lowpass = 0.f;
+    T bandpass = 0.f;
+    T highpass = 0.f;
+
+    // cutoff is normalized (frequency / sampleRate, below 0.5); q of 0.5 is
+    // critically damped, higher values ring
+    void setCutoff(T cutoff, T q) {
+        T w = float(M_PI) * cutoff;
+        g = rack::simd::sin(w) / rack::simd::cos(w);
+        k = 1.f / q;
+        a1 = 1.f / (1.f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+
+    MPDSP_INLINE void process(T x) {
+        T v3 = x - ic2;
+        T v1 = a1 * ic1 + a2 * v3;
+        T v2 = ic2 + a2 * ic1 + a3 * v3;
+        ic1 = flushDenormal(2.f * v1 - ic1);
+        ic2 = flushDenormal(2.f * v2 - ic2);
+        lowpass = v2;
+        bandpass = v1;
+        highpass = x - k * v1 - v2;
+    }
+
+    void reset() {
+        ic1 = ic2 = 0.f;
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,43 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Linear read of a single-cycle table at phase 0..1. SIZE must be a power of
+// two; the table holds SIZE samples and wraps at the end
+template <int SIZE>
+MPDSP_INLINE float readTable(const float* table, float phase) {
+    static_assert((SIZE & (SIZE - 1)) == 0, "table size must be a power of two");
+    float pos = phase * (float)SIZE;
+    int i = (int)pos;
+    float frac = pos - (float)i;
+    float y0 = table[i & (SIZE - 1)];
+    float y1 = table[(i + 1) & (SIZE - 1)];
+    return y0 + (y1 - y0) * frac;
+}
+
+// Four phases at once, one lookup per lane
+template <int SIZE>
+MPDSP_INLINE rack::simd::float_4 readTable(const float* table, rack::simd::float_4 phase) {
+    rack::simd::float_4 out;
+    for (int i = 0; i < 4; i++) {
+        out[i] = readTable<SIZE>(table, phase[i]);
+    }
+    return out;
+}
+
+// Table plus phase for the common one-table, one-voice case
+template <int SIZE>
+struct TableOscillator {
+    float table[SIZE] = {};
+    float phase = 0.f;
+
+    MPDSP_INLINE float process(float increment) {
+        float out = readTable<SIZE>(table, phase);
+        phase += increment;
+        phase -= std::floor(phase);
+        return out;
+    }
+};
+
+} // namespace mpdsp
@@ -0,0 +1,51 @@
+#pragma once
+#include "Common.hpp"
+
+namespace mpdsp {
+
+// Read-only lookup tables shared by every module in the process. They are
+// built on the first call to sharedTables(); modules keep the pointer from
+// their constructor so that never happens on the audio thread. In the
+// combined plugin all models use the one copy
+struct Tables {
+    static const int SINE_SIZE = 4096;
+    static const int WINDOW_SIZE = 4096;
+
+    // Each table has a guard point at the end for interpolation
+    float sine[SINE_SIZE + 1];
+    float hannWindow[WINDOW_SIZE + 1];
+
+    Tables() {
+        for (int i = 0; i <= SINE_SIZE; i++) {
+            sine[i] = std::sin(2.0 * M_PI * i / SINE_SIZE);
+        }
+        for (int i = 0; i <= WINDOW_SIZE; i++) {
+            hannWindow[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / WINDOW_SIZE);
+        }
+    }
+
+    // sin(2*pi*phase) for any phase, error about 4e-7
+    MPDSP_INLINE float sin2pi(float phase) const {
+        float pos = (phase - std::floor(phase)) * SINE_SIZE;
+        int i = (int)pos;
+        float frac = pos - (float)i;
+        i &= SINE_SIZE - 1;
+        return sine[i] + (sine[i + 1] - sine[i]) * frac;
+    }
+
+    // Hann window over phase 0..1, zero at both ends
+    MPDSP_INLINE float hann(float phase) const {
+        float pos = (phase - std::floor(phase)) * WINDOW_SIZE;
+        int i = (int)pos;
+        float frac = pos - (float)i;
+        i &= WINDOW_SIZE - 1;
+        return hannWindow[i] + (hannWindow[i + 1] - hannWindow[i]) * frac;
+    }
+};
+
+inline const Tables* sharedTables() {
+    static const Tables tables;
+    return &tables;
+}
+
+} // namespace mpdsp
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include "Common.hpp"
+#include "TableOscillator.hpp"
+
+namespace mpdsp {
+
+// Stack of single-cycle frames for a morphing oscillator. A morph position
+// picks two neighbouring frames and a blend; reads interpolate along the
+// cycle and crossfade between the pair. A bank is read-only once filled, so
+// one copy can serve every instance of a module
+template <int SIZE>
+struct WavetableBank {
+    std::vector<float> samples;
+    int frames;
+
+    struct Cursor {
+        const float* a = nullptr;
+        const float* b = nullptr;
+        float blend = 0.f;
+    };
+
+    explicit WavetableBank(int frames) : samples(frames * SIZE, 0.f), frames(frames) {}
+
+    float* frame(int k) {
+        return &samples[k * SIZE];
+    }
+
+    const float* frame(int k) const {
+        return &samples[k * SIZE];
+    }
+
+    // position runs 0..frames - 1
+    Cursor locate(float position) const {
+        position = rack::math::clamp(position, 0.f, (float)(frames - 1));
+        int k = std::min((int)position, std::max(frames - 2, 0));
+        Cursor cursor;
+        cursor.a = frame(k);
+        cursor.b = frame(std::min(k + 1, frames - 1));
+        cursor.blend = position - (float)k;
+        return cursor;
+    }
+
+    // Sample i of the morphed cycle
+    static MPDSP_INLINE float at(const Cursor& cursor, int i) {
+        i &= SIZE - 1;
+        return cursor.a[i] + (cursor.b[i] - cursor.a[i]) * cursor.blend;
+    }
+
+    // Morphed cycle at phase 0..1; T is float or rack::simd::float_4
+    template <typename T>
+    static MPDSP_INLINE T read(const Cursor& cursor, T phase) {
+        T a = readTable<SIZE>(cursor.a, phase);
+        T b = readTable<SIZE>(cursor.b, phase);
+        return a + (b - a) * cursor.blend;
+    }
+};
+
+} // namespace mpdsp
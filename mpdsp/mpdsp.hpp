@@ -0,0 +1,22 @@
+#pragma once
+
+// Everything in the shared DSP core at once
+#include "Common.hpp"
+#include "Aligned.hpp"
+#include "AllPass.hpp"
+#include "BufferPool.hpp"
+#include "Chebyshev.hpp"
+#include "ControlParam.hpp"
+#include "CvParam.hpp"
+#include "DelayLine.hpp"
+#include "Denormal.hpp"
+#include "FastMath.hpp"
+#include "IdleDetector.hpp"
+#include "Phasor.hpp"
+#include "Quality.hpp"
+#include "RandomStream.hpp"
+#include "Smoother.hpp"
+#include "Svf.hpp"
+#include "TableOscillator.hpp"
+#include "Tables.hpp"
+#include "WavetableBank.hpp"